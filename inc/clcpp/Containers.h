@@ -42,6 +42,26 @@ namespace clcpp
 	};
 
 
+	//
+	// Describes a run of container values laid out in memory at a fixed stride, allowing
+	// them to be read or written without a virtual call per value. Containers with keys
+	// can't be described this way.
+	//
+	struct ContainerSpan
+	{
+		ContainerSpan()
+			: data(0)
+			, count(0)
+			, stride(0)
+		{
+		}
+
+		void* data;
+		unsigned int count;
+		size_type stride;
+	};
+
+
 	//
 	// The interface that the various read iterators for containers must
 	// derive from.
@@ -59,6 +79,14 @@ namespace clcpp
 
 		// Move onto the next value in the container
 		virtual void MoveNext() = 0;
+
+		// Optionally describe all values from the current iterator position onwards as a
+		// contiguous span, returning false if the container doesn't store them that way.
+		// The iterator position is left unchanged and the values must not be modified.
+		virtual bool GetContiguous(ContainerSpan& /*span*/) const
+		{
+			return false;
+		}
 	};
 
 
@@ -84,6 +112,26 @@ namespace clcpp
 		// and return a pointer to that value so that it can be written to. Moves onto the next
 		// value after the call.
 		virtual void* AddEmpty(void* key) = 0;
+
+		// Optionally allocate up to count empty values at the current iterator position in one
+		// go, returning them as a contiguous span that can be written to. Containers that store
+		// their values in blocks can return fewer than requested, with the caller asking again
+		// for the rest. Returns false if the container can't hand out values this way, in which
+		// case AddEmpty must be used. Moves past all the values in the span after the call.
+		// This is the write-side counterpart of IReadIterator::GetContiguous and the only way
+		// of writing values in bulk.
+		virtual bool AddEmptyRange(unsigned int /*count*/, ContainerSpan& /*span*/)
+		{
+			return false;
+		}
+
+		// Optionally report that values can keep being added beyond the count given on
+		// initialisation, growing the container as needed. Such containers can be written
+		// without knowing how many values there are up front.
+		virtual bool CanGrow() const
+		{
+			return false;
+		}
 	};
 
 
@@ -145,6 +193,10 @@ namespace clcpp
 		{
 			((IReadIterator*)m_ImplData)->MoveNext();
 		}
+		bool GetContiguous(ContainerSpan& span) const
+		{
+			return ((IReadIterator*)m_ImplData)->GetContiguous(span);
+		}
 
     private:
         bool m_Initialised;
@@ -160,7 +212,9 @@ namespace clcpp
 		WriteIterator();
 		~WriteIterator();
 
-		// Construct from a type with the number of elements you're going to write
+		// Construct from a type with the number of elements you're going to write. If the count
+		// isn't known, pass a negative count: the iterator is only initialised if the container
+		// can grow as values are added.
 		void Initialise(const Type* type, void* container_object, int count);
 
 		// Construct from a field; can only be used to construct write iterators for
@@ -178,6 +232,14 @@ namespace clcpp
 		{
 			return ((IWriteIterator*)m_ImplData)->AddEmpty(key);
 		}
+		bool AddEmptyRange(unsigned int count, ContainerSpan& span)
+		{
+			return ((IWriteIterator*)m_ImplData)->AddEmptyRange(count, span);
+		}
+		bool CanGrow() const
+		{
+			return ((IWriteIterator*)m_ImplData)->CanGrow();
+		}
 
 	private:
 		bool m_Initialised;
@@ -0,0 +1,83 @@
+//
+// ===============================================================================
+// clReflect, DatabaseHandle.h - Hot-swapping of reflection databases between
+// threads, with deferred reclamation of old databases
+// -------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 Don Williamson & clReflect Authors (see AUTHORS file)
+// Released under MIT License (see LICENSE file)
+// ===============================================================================
+//
+
+#pragma once
+
+
+#include "clcpp.h"
+
+
+namespace clcpp
+{
+	//
+	// Holds the current database for a set of reader threads, allowing a freshly loaded database
+	// to be swapped in without stopping them. Readers that are using the old database can keep
+	// doing so until they finish reading; the old database is then handed back to the writer to
+	// unload, using epoch-based reclamation.
+	//
+	// Each reader thread is assigned a slot with AddReader and brackets its use of the database
+	// with BeginRead/EndRead, which never block. Slots are released with RemoveReader when a reader
+	// thread exits, for reuse by later readers. Reads can't be nested within the same slot.
+	// Swap and Reclaim must only be called from one thread at a time.
+	//
+	class CLCPP_API DatabaseHandle
+	{
+	public:
+		enum
+		{
+			MAX_READERS = 64,
+			MAX_RETIRED = 16,
+		};
+
+		DatabaseHandle();
+
+		// Allocate a slot for a new reader thread, and release it once the thread has finished reading
+		unsigned int AddReader();
+		void RemoveReader(unsigned int reader);
+
+		// Returns the current database, which remains valid until the matching EndRead
+		const Database* BeginRead(unsigned int reader);
+		void EndRead(unsigned int reader);
+
+		// Make a loaded database current, retiring the previous one. Returns false without
+		// swapping if there are too many retired databases waiting to be reclaimed.
+		bool Swap(Database* database);
+
+		// Returns a retired database that no reader can still be using, or null if there are none
+		// ready. The caller is responsible for unloading and destroying it. Swap in a null database
+		// and reclaim until null is returned to release everything on shutdown.
+		Database* Reclaim();
+
+	private:
+		// Disable copying
+		DatabaseHandle(const DatabaseHandle&);
+		DatabaseHandle& operator=(const DatabaseHandle&);
+
+		Database* volatile m_Database;
+
+		// Incremented after every swap
+		volatile unsigned int m_Epoch;
+
+		// Non-zero for each slot that's assigned to a reader
+		volatile unsigned int m_ReaderUsed[MAX_READERS];
+
+		// Epoch each reader began reading in, or zero if they're not reading
+		volatile unsigned int m_ReaderEpochs[MAX_READERS];
+
+		// Databases retired by Swap in the epoch before the swap
+		struct Retired
+		{
+			Database* database;
+			unsigned int epoch;
+		};
+		Retired m_Retired[MAX_RETIRED];
+		unsigned int m_NbRetired;
+	};
+}
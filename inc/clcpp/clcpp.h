@@ -408,6 +408,92 @@ namespace clcpp
         // Combines two hashes by using the first one as a seed and hashing the second one
         //
         CLCPP_API unsigned int MixHashes(unsigned int a, unsigned int b);
+
+        //
+        // Compile-time implementation of the MurmurHash3 used by HashData and HashNameString. These are
+        // written as single-expression recursive functions so that they're constexpr under C++11.
+        //
+        namespace murmur3
+        {
+            constexpr unsigned int Rotl(unsigned int v, unsigned int bits)
+            {
+                return (v << bits) | (v >> (32 - bits));
+            }
+
+            constexpr unsigned int MixK(unsigned int k)
+            {
+                return Rotl(k * 0xcc9e2d51, 15) * 0x1b873593;
+            }
+
+            constexpr unsigned int MixH(unsigned int h, unsigned int k)
+            {
+                return Rotl(h ^ MixK(k), 13) * 5 + 0xe6546b64;
+            }
+
+            constexpr unsigned int Byte(const char* data, int index)
+            {
+                return (unsigned char)data[index];
+            }
+
+            constexpr unsigned int Block(const char* data)
+            {
+                return Byte(data, 0) | (Byte(data, 1) << 8) | (Byte(data, 2) << 16) | (Byte(data, 3) << 24);
+            }
+
+            constexpr unsigned int Body(const char* data, int nb_blocks, unsigned int h)
+            {
+                return nb_blocks == 0 ? h : Body(data + 4, nb_blocks - 1, MixH(h, Block(data)));
+            }
+
+            constexpr unsigned int TailBlock(const char* tail, int len)
+            {
+                return len == 3 ? Byte(tail, 0) | (Byte(tail, 1) << 8) | (Byte(tail, 2) << 16)
+                     : len == 2 ? Byte(tail, 0) | (Byte(tail, 1) << 8)
+                                : Byte(tail, 0);
+            }
+
+            constexpr unsigned int Tail(const char* tail, int len, unsigned int h)
+            {
+                return len == 0 ? h : h ^ MixK(TailBlock(tail, len));
+            }
+
+            constexpr unsigned int Fmix3(unsigned int h)
+            {
+                return h ^ (h >> 16);
+            }
+
+            constexpr unsigned int Fmix2(unsigned int h)
+            {
+                return Fmix3((h ^ (h >> 13)) * 0xc2b2ae35);
+            }
+
+            constexpr unsigned int Fmix(unsigned int h)
+            {
+                return Fmix2((h ^ (h >> 16)) * 0x85ebca6b);
+            }
+
+            constexpr unsigned int Hash(const char* data, int len, unsigned int seed)
+            {
+                return Fmix(Tail(data + (len & ~3), len & 3, Body(data, len / 4, seed)) ^ (unsigned int)len);
+            }
+
+            constexpr int StrLen(const char* str, int len = 0)
+            {
+                return str[len] == 0 ? len : StrLen(str, len + 1);
+            }
+        }
+
+        //
+        // Compile-time equivalents of HashData and HashNameString, returning identical values
+        //
+        constexpr unsigned int HashDataConst(const char* data, int length, unsigned int seed = 0)
+        {
+            return murmur3::Hash(data, length, seed);
+        }
+        constexpr unsigned int HashNameStringConst(const char* name_string, unsigned int seed = 0)
+        {
+            return murmur3::Hash(name_string, murmur3::StrLen(name_string), seed);
+        }
     }
 
     //
@@ -461,6 +547,19 @@ namespace clcpp
         virtual bool Read(void* dest, size_type size) = 0;
     };
 
+    //
+    // Optional interface for spreading independent pieces of work across the client's worker
+    // threads. The database loader uses this to patch pointers in parallel.
+    //
+    struct clcpp_attr(reflect_part) IJobRunner
+    {
+        typedef void (*JobFunction)(void* job_data, unsigned int job_index);
+
+        // Call the job function once for every job index in [0, nb_jobs), in any order and on
+        // any thread, returning only when all jobs have completed.
+        virtual void Run(JobFunction job_function, void* job_data, unsigned int nb_jobs) = 0;
+    };
+
     //
     // Represents the range [start, end) for iterating over an array
     //
@@ -488,6 +587,7 @@ namespace clcpp
     namespace internal
     {
         struct DatabaseMem;
+        struct DatabaseFileHeader;
 
         //
         // All primitive arrays are sorted in order of increasing name hash. This will perform an
@@ -709,6 +809,9 @@ namespace clcpp
         // Types this one derives from. Can be either a Class or TemplateType.
         CArray<const Type*> base_types;
 
+        // Sorted name hashes of every type this one derives from, directly or indirectly
+        CArray<unsigned int> ancestor_hashes;
+
         // This is non-null if the type is a registered container
         ContainerInfo* ci;
     };
@@ -734,12 +837,24 @@ namespace clcpp
 
         Enum();
 
+        // Find the constant with the given value, returning null if there is none. If several
+        // constants share the value, the first in the name-sorted constants array is returned.
+        const EnumConstant* FindConstantByValue(int value) const;
+
         const char* GetValueName(int value) const;
 
         // All sorted by name
         CArray<const EnumConstant*> constants;
         CArray<const Attribute*> attributes;
 
+        // Constants sorted by value, with only one constant per unique value
+        CArray<const EnumConstant*> sorted_constants;
+
+        // If the range of values is compact, this is a table of constants indexed by
+        // (value - value_table_min), with null entries for values that have no constant
+        int value_table_min;
+        CArray<const EnumConstant*> value_table;
+
         // Bits representing some of the flag attributes in the attribute array
         unsigned int flag_attributes;
     };
@@ -862,6 +977,23 @@ namespace clcpp
         CArray<const Attribute*> attributes;
         CArray<const Template*> templates;
 
+        // Fields of this class and all its base classes, sorted by name. Fields hide any base
+        // class fields of the same name. Shares its memory with the fields array when the class
+        // has no base classes.
+        CArray<const Field*> all_fields;
+
+        // The fields in all_fields sorted by offset, giving their declaration order. Shares its memory
+        // with all_fields if they're already in that order.
+        CArray<const Field*> all_fields_by_offset;
+
+        // Flag attributes of every base class that each field in all_fields is inherited through, combined
+        // so that fields of transient base classes can be skipped without searching the hierarchy. Empty
+        // if none of the fields are inherited through a class with flag attributes.
+        CArray<unsigned int> all_fields_base_flags;
+
+        // The base class flags of the fields in all_fields_by_offset, sharing memory in the same way
+        CArray<unsigned int> all_fields_by_offset_base_flags;
+
         // Bits representing some of the flag attributes in the attribute array
         unsigned int flag_attributes;
     };
@@ -913,22 +1045,103 @@ namespace clcpp
             // using the load address of the calling module. Use this flag to disable
             // this behaviour.
             OPT_DONT_REBASE_FUNCTIONS = 0x00000001,
+
+            // Primitive::database is left null. Combined with OPT_DONT_REBASE_FUNCTIONS, this ensures
+            // that a database exported with a prelink address (clexport -cpp_prelink) and mapped at
+            // that address with LoadMapped is never written to; it can be mapped read-only and
+            // shared between processes.
+            OPT_DONT_PARENT_PRIMITIVES = 0x00000002,
+
+            // Only the core section is loaded up-front, with the remaining sections loaded the first
+            // time an API function or clutl serialiser needs them. This saves relocating, and with
+            // LoadMapped paging in, data that is never used. Sections can be loaded concurrently from
+            // multiple reader threads. Code that reaches sections through primitives rather than the
+            // database, such as Class::methods, Function::parameters or attributes, must call
+            // RequireSection before use. Sections can only be loaded through primitives that are
+            // parented to the database so this is ignored with OPT_DONT_PARENT_PRIMITIVES.
+            OPT_LOAD_SECTIONS_ON_DEMAND = 0x00000004,
+        };
+
+        // Sections of the database that can be loaded independently
+        enum Section
+        {
+            // Types, enums, classes, fields, templates, namespaces and container info
+            SECTION_CORE,
+
+            // The list of all names used by GetName
+            SECTION_NAMES,
+
+            // The text of all names. This is only deferred when the database was exported with compact
+            // names, in which case the text is rebuilt on load and reads as empty until then. GetName,
+            // Enum::GetValueName and the JSON serialiser load it; other code reading Name::text through
+            // primitives must call RequireSection first.
+            SECTION_NAME_TEXT,
+
+            // Functions, their parameters and the function lists of classes and namespaces
+            SECTION_FUNCTIONS,
+
+            // All attributes and the attribute lists of primitives
+            SECTION_ATTRIBUTES,
+
+            NB_SECTIONS
         };
 
         Database();
         ~Database();
 
         bool Load(IFile* file, IAllocator* allocator, unsigned int options);
-        bool Load(IFile* file, IAllocator* allocator, pointer_type base_address, unsigned int options);
+        bool Load(IFile* file, IAllocator* allocator, pointer_type base_address, unsigned int options,
+                  IJobRunner* job_runner = 0);
+
+        // Load a database directly from the contents of a cppbin file that has already been mapped
+        // into memory, without allocating or copying. Pointers are patched in-place so the memory
+        // must be writable (e.g. mmap with PROT_READ|PROT_WRITE and MAP_PRIVATE); only those pages
+        // containing pointers are written to. The memory must outlive the database.
+        // If the file was exported with a prelink address and is mapped there, no pointers are patched
+        // and, with OPT_DONT_REBASE_FUNCTIONS | OPT_DONT_PARENT_PRIMITIVES, a read-only mapping is safe.
+        // If a job runner is provided to either load function, pointers are patched in parallel.
+        bool LoadMapped(void* data, size_type size, unsigned int options);
+        bool LoadMapped(void* data, size_type size, pointer_type base_address, unsigned int options,
+                        IJobRunner* job_runner = 0);
+
+        // Use a database that was exported as C++ source (clexport -cpp_src) and linked into the
+        // executable, passing the array it defines. Nothing is allocated, copied or relocated and
+        // primitives aren't parented to the database, as with OPT_DONT_PARENT_PRIMITIVES. Functions are
+        // exported to a separate writable array and their addresses are rebased in-place on the first
+        // load, which must not race with another load of the same array or calls through it.
+        bool LoadStatic(const void* data);
+        bool LoadStatic(const void* data, pointer_type base_address);
+
 		bool UnLoad();
+
+        // Explicitly load a section that was deferred with OPT_LOAD_SECTIONS_ON_DEMAND
+        void LoadSection(Section section, IJobRunner* job_runner = 0);
+        bool IsSectionLoaded(Section section) const;
+
+        // Load a deferred section on first use. This is safe to call from multiple threads reading
+        // the same database.
+        void RequireSection(Section section) const;
+
         // This returns the name as it exists in the name database, with the text pointer
         // pointing to within the database's allocated name data
         Name GetName(unsigned int hash) const;
         Name GetName(const char* text) const;
 
+        // Write the null-terminated text of a name to a caller-provided buffer, returning the length
+        // of the text or zero if the name can't be found. If the buffer is too small, an empty string
+        // is written instead. With compact names, this doesn't need the name text section loaded.
+        size_type GetNameText(unsigned int hash, char* buffer, size_type buffer_size) const;
+
         // Return either a type, enum, template type or class by hash
         const Type* GetType(unsigned int hash) const;
 
+        // Batched versions of GetName, GetType and GetFunction that resolve many hashes at once,
+        // overlapping the memory latency of independent lookups. Hashes that can't be found
+        // output an empty name or null pointer.
+        void GetNames(const unsigned int* hashes, unsigned int nb_hashes, Name* out_names) const;
+        void GetTypes(const unsigned int* hashes, unsigned int nb_hashes, const Type** out_types) const;
+        void GetFunctions(const unsigned int* hashes, unsigned int nb_hashes, const Function** out_functions) const;
+
         // Retrieve namespaces using their fully-scoped names
         const Namespace* GetNamespace(unsigned int hash) const;
 
@@ -943,6 +1156,7 @@ namespace clcpp
         const Function* GetFunction(unsigned int hash) const;
         Range GetOverloadedFunction(unsigned int hash) const;
 
+        // Types can't be replaced in static databases, which are read-only
         const clcpp::Type** GetTypes(unsigned int& out_nb_types) const;
         void SetTypes(const clcpp::Type** types, unsigned int nb_types);
 
@@ -958,11 +1172,35 @@ namespace clcpp
         Database(const Database&);
         Database& operator=(const Database&);
 
+        void LoadSections(pointer_type base_address, unsigned int options, IJobRunner* job_runner);
+
         internal::DatabaseMem* m_DatabaseMem;
 
         // Allocator used to load the database
         IAllocator* m_Allocator;
+
+        // File header and pointer relocation data, retained while there are sections left to load
+        const internal::DatabaseFileHeader* m_FileHeader;
+        const char* m_RelocationData;
+
+        // Load parameters and bit mask of loaded sections
+        pointer_type m_BaseAddress;
+        unsigned int m_Options;
+        volatile unsigned int m_LoadedSections;
+
+        // Held while a section is loaded so that concurrent readers don't relocate it twice
+        volatile unsigned int m_SectionLock;
     };
+
+    //
+    // Ensure a section is loaded in the database a primitive belongs to, for databases loaded with
+    // OPT_LOAD_SECTIONS_ON_DEMAND. Primitives without a database are always fully loaded.
+    //
+    inline void RequireSection(const Primitive* primitive, Database::Section section)
+    {
+        if (primitive->database != 0)
+            primitive->database->RequireSection(section);
+    }
 };
 
 // ===============================================================================
@@ -997,6 +1235,16 @@ namespace clcpp
     }
 }
 
+//
+// Compile-time name hash literal, equivalent to clcpp::internal::HashNameString:
+//
+//    const clcpp::Type* type = db.GetType("ns::Type"_clhash);
+//
+constexpr unsigned int operator""_clhash(const char* name_string, decltype(sizeof(0)) length)
+{
+    return clcpp::internal::murmur3::Hash(name_string, (int)length, 0);
+}
+
 //
 // Compile-time typename hash
 //
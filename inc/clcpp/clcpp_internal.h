@@ -6,6 +6,32 @@ namespace clcpp
 {
 	namespace internal
 	{
+		//
+		// Entry in an open-addressed hash table that maps a name hash to the index of the first
+		// primitive with that name in a sorted primitive array. Empty slots have a hash of zero.
+		//
+		struct HashIndexSlot
+		{
+			HashIndexSlot();
+
+			unsigned int hash;
+			unsigned int index;
+		};
+
+
+		//
+		// Name stored as a reference to the longest name that prefixes it, followed by the rest
+		// of its text. Names without a prefix name have a parent of -1.
+		//
+		struct CompactName
+		{
+			CompactName();
+
+			int parent;
+			unsigned int suffix_offset;
+		};
+
+
 		//
 		// Memory-mapped representation of the entire reflection database
 		//
@@ -22,6 +48,11 @@ namespace clcpp
 			// Mapping from hash to text string
 			CArray<Name> names;
 
+			// When exported with compact names, the name text isn't stored in the file and is rebuilt
+			// from these, which match the name array by index. Suffixes are null-terminated.
+			CArray<CompactName> compact_names;
+			const char* compact_name_suffix_data;
+
 			// Ownership storage of all referenced primitives
 			CArray<Type> types;
 			CArray<EnumConstant> enum_constants;
@@ -50,6 +81,18 @@ namespace clcpp
 			// A list of all registered containers
 			CArray<ContainerInfo> container_infos;
 
+			// Hash tables for O(1) lookup of primitives in the above arrays by name. These have a
+			// power-of-two size and are searched with linear probing.
+			CArray<HashIndexSlot> name_index;
+			CArray<HashIndexSlot> type_index;
+			CArray<HashIndexSlot> namespace_index;
+			CArray<HashIndexSlot> template_index;
+			CArray<HashIndexSlot> function_index;
+
+			// Name hashes of the sorted function array, packed so that gathering the overloads
+			// either side of an index lookup doesn't need to touch the functions themselves
+			CArray<unsigned int> function_hashes;
+
 			// The root namespace that allows you to reach every referenced primitive
 			Namespace global_namespace;
 		};
@@ -74,9 +117,39 @@ namespace clcpp
 			int nb_ptr_offsets;
 			int nb_ptr_relocations;
 
+			// Pointer relocation instructions are sorted by database section, with this many in each
+			int nb_section_ptr_relocations[clcpp::Database::NB_SECTIONS];
+
 			clcpp::size_type data_size;
 
+			// Address of the memory-mapped data that all pointers were relative to when exported. When
+			// non-zero and the data is loaded at this address, no pointer relocation is needed.
+			clcpp::pointer_type prelink_address;
+
+			// When non-zero, the memory-mapped data is stored as a sequence of compressed blocks that
+			// decompress to this many bytes each, with the last block holding the remainder. Each block
+			// is preceded by its compressed size, with COMPRESSED_BLOCK_STORED set if it's stored raw.
+			unsigned int compression_block_size;
+
+			// When exported with compact names, this range of the memory-mapped data holds the name
+			// text and is left out of the file, with the data that follows it moved down to fill the gap
+			clcpp::size_type name_text_offset;
+			clcpp::size_type name_text_size;
+
 			// TODO: CRC verify?
 		};
+
+
+		// Flags the size of a compressed block that couldn't be compressed and is stored raw
+		const unsigned int COMPRESSED_BLOCK_STORED = 0x80000000;
+
+		//
+		// Simple block compression used to store memory-mapped data. Compressed output is never
+		// larger than CompressBlockBound of the input size. DecompressBlock returns false if the
+		// compressed data is corrupt or doesn't decompress to exactly dest_size bytes.
+		//
+		CLCPP_API size_type CompressBlockBound(size_type size);
+		CLCPP_API size_type CompressBlock(const void* src, size_type src_size, void* dest);
+		CLCPP_API bool DecompressBlock(const void* src, size_type src_size, void* dest, size_type dest_size);
 	}
 }
\ No newline at end of file
@@ -87,6 +87,12 @@ namespace clutl
 	public:
 		JSONContext(clutl::ReadBuffer& read_buffer);
 
+		// Streams input from the source in chunks of the given size as the lexer needs it, only
+		// keeping in memory what the parser may still refer to
+		JSONContext(clutl::IReadSource& source, unsigned int chunk_size);
+
+		~JSONContext();
+
 		// Consume the given amount of characters in the data buffer, assuming
 		// they have been parsed correctly. The original position before the
 		// consume operation is returned.
@@ -113,10 +119,31 @@ namespace clutl
 		void PushState(const clutl::JSONToken& token);
 		void PopState(clutl::JSONToken& token);
 
+		// Called by the lexer before each token, releasing any streamed input that only the token
+		// before last referenced
+		void BeginToken();
+
+		// Move the start of the current token past any whitespace
+		void MoveTokenStart();
+
+		// Pointer to the first character of the current token
+		const char* TokenStart();
+
 		clutl::JSONError GetError() const { return m_Error; }
 
 
 	private:
+		// Disable copying
+		JSONContext(const JSONContext&);
+		JSONContext& operator=(const JSONContext&);
+
+		// Stream in more input until there are at least size characters left to read, returning
+		// false if the input ends first
+		bool Fill(unsigned int size);
+
+		// Position of the next character to read from the start of all input
+		unsigned int Position() const;
+
 		// Parsing state
 		clutl::ReadBuffer& m_ReadBuffer;
 		clutl::JSONError m_Error;
@@ -126,6 +153,16 @@ namespace clutl
 		// One-level deep parsing state stack
 		unsigned int m_StackPosition;
 		clutl::JSONToken m_StackToken;
+		unsigned int m_StackTokenPosition;
+
+		// Streaming input state, with the read buffer referencing the window of input in memory
+		clutl::IReadSource* m_Source;
+		clutl::ReadBuffer m_StreamBuffer;
+		char* m_Window;
+		char* m_RetiredWindow;
+		unsigned int m_WindowCapacity;
+		unsigned int m_WindowPosition;
+		unsigned int m_TokenPosition;
 	};
 
 
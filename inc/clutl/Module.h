@@ -24,7 +24,7 @@ namespace clcpp
 namespace clutl
 {
 	//
-	// Represents a DLL on Windows, the only supported platform, currently
+	// Represents a DLL on Windows or a shared library loaded with dlopen on Linux/Mac
 	//
 	class CLCPP_API Module
 	{
@@ -42,6 +42,9 @@ namespace clutl
 		//
 		bool Load(clcpp::Database* host_db, const char* filename);
 
+		// Release the module, after which its reflection database can no longer be used
+		void Unload();
+
 		void* GetFunction(const char* name) const;
 		
 		const clcpp::Database* GetReflectionDB() const { return m_ReflectionDB; }
@@ -56,4 +59,42 @@ namespace clutl
 		// Module database
 		const clcpp::Database* m_ReflectionDB;
 	};
+
+
+	//
+	// A merged index of the types in the host database and any loaded modules, for finding a type
+	// by name hash without searching each database in turn. Databases are added and removed
+	// incrementally as modules are loaded and unloaded. If more than one database contains a type
+	// with the same name, which of them is returned is unspecified. Not thread-safe.
+	//
+	class CLCPP_API ModuleRegistry
+	{
+	public:
+		ModuleRegistry();
+		~ModuleRegistry();
+
+		// Add or remove all types in a database
+		void AddDatabase(const clcpp::Database* db);
+		void RemoveDatabase(const clcpp::Database* db);
+
+		// Add or remove the types in the reflection database of a loaded module, if it has one.
+		// Modules must be removed before they're unloaded.
+		void AddModule(const Module& module);
+		void RemoveModule(const Module& module);
+
+		const clcpp::Type* GetType(unsigned int hash) const;
+
+	private:
+		struct HashEntry;
+
+		void AddHashEntry(const clcpp::Type* type);
+		void RemoveHashEntry(const clcpp::Type* type);
+		void Resize(bool increase);
+
+		// An open-addressed hash table with linear probing, using the same scheme as clobj::ObjectGroup
+		unsigned int m_MaxNbTypes;
+		unsigned int m_NbTypes;
+		unsigned int m_NbOccupiedEntries;
+		HashEntry* m_Types;
+	};
 }
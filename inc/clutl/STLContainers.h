@@ -0,0 +1,319 @@
+//
+// ===============================================================================
+// clReflect, STLContainers.h - Reflected iterators for standard library containers
+// -------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 Don Williamson & clReflect Authors (see AUTHORS file)
+// Released under MIT License (see LICENSE file)
+// ===============================================================================
+//
+
+#pragma once
+
+
+#include <clcpp/Containers.h>
+
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+
+#ifdef __clcpp_parse__
+
+	//
+	// Equivalent of clcpp_container_iterators that accepts container types with commas in them
+	//
+	#define clutl_std_container_spec(read_iterator, write_iterator, keyinfo, ...) \
+		clcpp_reflect_part(read_iterator) clcpp_reflect_part(write_iterator) namespace clcpp_internal \
+		{ \
+			struct __attribute__((annotate("container-" #__VA_ARGS__ "-" #read_iterator "-" #write_iterator "-" #keyinfo))) \
+			CLCPP_UNIQUE(container_info) \
+			{ \
+			}; \
+		}
+
+#else
+
+	#define clutl_std_container_spec(read_iterator, write_iterator, keyinfo, ...)
+
+#endif
+
+
+//
+// Declares reflected read/write iterators named NAME##ReadIterator and NAME##WriteIterator for
+// the given standard library container and registers them with clReflect. Call from the global
+// namespace, spelling the container type without spaces, exactly as clReflect names its template
+// instance, e.g.
+//
+//    clutl_std_vector_iterators(IntVector, std::vector<int,std::allocator<int>>)
+//
+// Vector-style iterators work with std::vector and std::basic_string. Map-style iterators work
+// with std::map and std::unordered_map.
+//
+#define clutl_std_vector_iterators(name, ...) \
+	struct name##ReadIterator : public clutl::StdVectorReadIterator<__VA_ARGS__> \
+	{ \
+	}; \
+	struct name##WriteIterator : public clutl::StdVectorWriteIterator<__VA_ARGS__> \
+	{ \
+	}; \
+	clcpp_impl_class(name##ReadIterator) \
+	clcpp_impl_class(name##WriteIterator) \
+	clutl_std_container_spec(name##ReadIterator, name##WriteIterator, nokey, __VA_ARGS__)
+
+#define clutl_std_map_iterators(name, ...) \
+	struct name##ReadIterator : public clutl::StdMapReadIterator<__VA_ARGS__> \
+	{ \
+	}; \
+	struct name##WriteIterator : public clutl::StdMapWriteIterator<__VA_ARGS__> \
+	{ \
+	}; \
+	clcpp_impl_class(name##ReadIterator) \
+	clcpp_impl_class(name##WriteIterator) \
+	clutl_std_container_spec(name##ReadIterator, name##WriteIterator, haskey, __VA_ARGS__)
+
+
+namespace clutl
+{
+	namespace internal
+	{
+		// Describe the key/value types of a container from its template instance
+		inline void SetContainerTypes(const clcpp::Primitive* primitive, clcpp::Iterator& storage, bool has_key)
+		{
+			clcpp::internal::Assert(primitive != 0);
+			clcpp::internal::Assert(primitive->kind == clcpp::Primitive::KIND_TEMPLATE_TYPE);
+			const clcpp::TemplateType* template_type = (const clcpp::TemplateType*)primitive;
+
+			int value_index = 0;
+			if (has_key)
+			{
+				storage.m_KeyType = template_type->parameter_types[0];
+				storage.m_KeyIsPtr = template_type->parameter_ptrs[0];
+				value_index = 1;
+			}
+
+			storage.m_ValueType = template_type->parameter_types[value_index];
+			storage.m_ValueIsPtr = template_type->parameter_ptrs[value_index];
+		}
+
+		// Serialisers only construct key storage for types reflected with a constructor
+		inline bool HasConstructor(const clcpp::Type* type)
+		{
+			if (type->kind == clcpp::Primitive::KIND_CLASS)
+				return type->AsClass()->constructor != 0;
+			if (type->kind == clcpp::Primitive::KIND_TEMPLATE_TYPE)
+				return type->AsTemplateType()->constructor != 0;
+			return false;
+		}
+
+		// Only hashed containers can reserve space for their values up-front
+		template <typename CONTAINER>
+		inline void Reserve(CONTAINER&, unsigned int)
+		{
+		}
+		template <typename KEY, typename VALUE, typename HASH, typename EQUAL, typename ALLOCATOR>
+		inline void Reserve(std::unordered_map<KEY, VALUE, HASH, EQUAL, ALLOCATOR>& container, unsigned int count)
+		{
+			container.reserve(count);
+		}
+	}
+
+
+	//
+	// Read iterator for containers that store their values contiguously
+	//
+	template <typename CONTAINER>
+	class StdVectorReadIterator : public clcpp::IReadIterator
+	{
+	public:
+		StdVectorReadIterator()
+			: m_Container(0)
+			, m_Position(0)
+		{
+		}
+
+		void Initialise(const clcpp::Primitive* primitive, const void* container_object, clcpp::ReadIterator& storage)
+		{
+			clcpp::internal::Assert(container_object != 0);
+			internal::SetContainerTypes(primitive, storage, false);
+			m_Container = (const CONTAINER*)container_object;
+			m_Position = 0;
+			storage.m_Count = (unsigned int)m_Container->size();
+		}
+
+		clcpp::ContainerKeyValue GetKeyValue() const
+		{
+			clcpp::internal::Assert(m_Position < m_Container->size());
+			clcpp::ContainerKeyValue kv;
+			kv.value = m_Container->data() + m_Position;
+			return kv;
+		}
+
+		void MoveNext()
+		{
+			m_Position++;
+		}
+
+		bool GetContiguous(clcpp::ContainerSpan& span) const
+		{
+			span.data = (void*)(m_Container->data() + m_Position);
+			span.count = (unsigned int)(m_Container->size() - m_Position);
+			span.stride = sizeof(typename CONTAINER::value_type);
+			return true;
+		}
+
+	private:
+		const CONTAINER* m_Container;
+		typename CONTAINER::size_type m_Position;
+	};
+
+
+	//
+	// Write iterator for containers that store their values contiguously. When the count is known,
+	// all values are reserved on initialisation so that adding them never reallocates.
+	//
+	template <typename CONTAINER>
+	class StdVectorWriteIterator : public clcpp::IWriteIterator
+	{
+	public:
+		StdVectorWriteIterator()
+			: m_Container(0)
+		{
+		}
+
+		void Initialise(const clcpp::Primitive* primitive, void* container_object, clcpp::WriteIterator& storage, int count)
+		{
+			clcpp::internal::Assert(container_object != 0);
+			internal::SetContainerTypes(primitive, storage, false);
+			m_Container = (CONTAINER*)container_object;
+			m_Container->clear();
+			m_Container->reserve(count);
+			storage.m_Count = count;
+		}
+
+		void* AddEmpty()
+		{
+			m_Container->resize(m_Container->size() + 1);
+			return &m_Container->back();
+		}
+
+		void* AddEmpty(void* /*key*/)
+		{
+			return AddEmpty();
+		}
+
+		bool AddEmptyRange(unsigned int count, clcpp::ContainerSpan& span)
+		{
+			// Default-construct all requested values at once and hand them out in place
+			typename CONTAINER::size_type size = m_Container->size();
+			m_Container->resize(size + count);
+			span.data = count != 0 ? &(*m_Container)[size] : 0;
+			span.count = count;
+			span.stride = sizeof(typename CONTAINER::value_type);
+			return true;
+		}
+
+		bool CanGrow() const
+		{
+			return true;
+		}
+
+	private:
+		CONTAINER* m_Container;
+	};
+
+
+	//
+	// Read iterator for associative containers
+	//
+	template <typename CONTAINER>
+	class StdMapReadIterator : public clcpp::IReadIterator
+	{
+	public:
+		StdMapReadIterator()
+			: m_Container(0)
+		{
+		}
+
+		void Initialise(const clcpp::Primitive* primitive, const void* container_object, clcpp::ReadIterator& storage)
+		{
+			clcpp::internal::Assert(container_object != 0);
+			internal::SetContainerTypes(primitive, storage, true);
+			m_Container = (const CONTAINER*)container_object;
+			m_Position = m_Container->begin();
+			storage.m_Count = (unsigned int)m_Container->size();
+		}
+
+		clcpp::ContainerKeyValue GetKeyValue() const
+		{
+			clcpp::internal::Assert(m_Position != m_Container->end());
+			clcpp::ContainerKeyValue kv;
+			kv.key = &m_Position->first;
+			kv.value = &m_Position->second;
+			return kv;
+		}
+
+		void MoveNext()
+		{
+			++m_Position;
+		}
+
+	private:
+		const CONTAINER* m_Container;
+		typename CONTAINER::const_iterator m_Position;
+	};
+
+
+	//
+	// Write iterator for associative containers. Hashed containers reserve all values on
+	// initialisation and keys are moved straight into their container nodes. Keys that aren't
+	// trivially copyable, such as strings, must be reflected with a constructor and destructor.
+	//
+	template <typename CONTAINER>
+	class StdMapWriteIterator : public clcpp::IWriteIterator
+	{
+	public:
+		StdMapWriteIterator()
+			: m_Container(0)
+		{
+		}
+
+		void Initialise(const clcpp::Primitive* primitive, void* container_object, clcpp::WriteIterator& storage, int count)
+		{
+			clcpp::internal::Assert(container_object != 0);
+			internal::SetContainerTypes(primitive, storage, true);
+			m_Container = (CONTAINER*)container_object;
+			m_Container->clear();
+
+			// Keys are moved from storage that the serialisers load them into (see clutl::ContainerKey),
+			// which is only a valid object for non-trivial types reflected with a constructor
+			clcpp::internal::Assert(std::is_trivially_copyable<typename CONTAINER::key_type>::value ||
+									internal::HasConstructor(storage.m_KeyType));
+			internal::Reserve(*m_Container, count);
+			storage.m_Count = count;
+		}
+
+		void* AddEmpty()
+		{
+			// Values can't be added without a key
+			clcpp::internal::Assert(false);
+			return 0;
+		}
+
+		void* AddEmpty(void* key)
+		{
+			typedef typename CONTAINER::key_type KeyType;
+			clcpp::internal::Assert(key != 0);
+			return &m_Container->emplace(std::piecewise_construct, std::forward_as_tuple(std::move(*(KeyType*)key)), std::tuple<>())
+				.first->second;
+		}
+
+		bool CanGrow() const
+		{
+			return true;
+		}
+
+	private:
+		CONTAINER* m_Container;
+	};
+}
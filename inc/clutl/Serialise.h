@@ -19,6 +19,26 @@ namespace clutl
     struct Object;
     class JSONContext;
 
+    //
+    // Destination for data that doesn't need to be kept in memory once written, such as a file or
+    // socket. Clients must implement this to stream serialised data out.
+    //
+    struct clcpp_attr(reflect_part) IWriteSink
+    {
+        // Write all of the data, returning true on success, false otherwise
+        virtual bool Write(const void* data, unsigned int length) = 0;
+    };
+
+    //
+    // Source of data that arrives over time, such as a file or socket, so that it doesn't need to be held
+    // in memory all at once. Clients must implement this to stream serialised data in.
+    //
+    struct clcpp_attr(reflect_part) IReadSource
+    {
+        // Read up to size bytes, returning how many were read or zero at the end of the data
+        virtual unsigned int Read(void* dest, unsigned int size) = 0;
+    };
+
     //
     // Growable write byte buffer
     //
@@ -27,11 +47,20 @@ namespace clutl
     public:
         WriteBuffer() = default;
         WriteBuffer(unsigned int initial_capacity);
+
+        // Fixed-capacity buffer that passes its contents on to the sink whenever it fills, instead of
+        // growing. Only data written since the last flush can be seeked over or read back.
+        WriteBuffer(IWriteSink* sink, unsigned int capacity);
+
         ~WriteBuffer();
 
         // Resets only the write position, ensuring none of the capacity already allocated is released
         void Reset();
 
+        // Pass everything written so far on to the sink and reset the write position. Returns false if
+        // there's no sink or any write to it has failed. Call this once done writing to a sink.
+        bool Flush();
+
         // Allocate space in the buffer, shifting the write position and returning a pointer to that space
         // Grows the capacity on demand
         void* Alloc(unsigned int length);
@@ -67,6 +96,9 @@ namespace clutl
         char* m_data = nullptr;
         char* m_dataEnd = nullptr;
         char* m_dataWrite = nullptr;
+
+        IWriteSink* m_sink = nullptr;
+        bool m_sinkFailed = false;
     };
 
     //
@@ -111,6 +143,31 @@ namespace clutl
         virtual unsigned int MapPtr(const void* ptr) = 0;
     };
 
+    //
+    // Stack storage for a container key while it's loaded, before it's passed to a write iterator.
+    // Keys with a reflected constructor are constructed in place, and destructed when this goes out
+    // of scope, so that types such as strings are valid objects to load into and move from.
+    //
+    class CLCPP_API ContainerKey
+    {
+    public:
+        ContainerKey(const clcpp::Type* type);
+        ~ContainerKey();
+
+        void* GetData()
+        {
+            return m_Data;
+        }
+
+    private:
+        // Disable copying
+        ContainerKey(const ContainerKey&);
+        ContainerKey& operator=(const ContainerKey&);
+
+        const clcpp::Function* m_Destructor;
+        alignas(16) char m_Data[128];
+    };
+
     // Binary serialisation
     CLCPP_API void SaveVersionedBinary(WriteBuffer& out, const void* object, const clcpp::Type* type);
     CLCPP_API void LoadVersionedBinary(ReadBuffer& in, void* object, const clcpp::Type* type);
@@ -156,12 +213,16 @@ namespace clutl
             // field array. This array is typically sorted in order of name hash so that look-up by name can use
             // a binary search.
             //
-            // This flag will ensure fields are saved in the order that they are declared by sorting them by their
-            // byte offset first.
-            //
-            // Note that use of this flag will slow serialisation as the inner loop will have to do loop quadratically
-            // over the field array.
+            // This flag will ensure fields are saved in the order that they are declared by using the offset-sorted
+            // field array exported with each class instead. This costs the same as saving in name hash order.
             SORT_CLASS_FIELDS_BY_OFFSET = 0x80,
+
+            // Arrays saved from template type containers open with a {"$n":count} element, letting the loader
+            // reserve space for the values before parsing them once. Without it, containers that can't grow as
+            // values are added need an extra counting pass over the array. Loaded counts are only trusted up to
+            // the number of values that could fit in the input left in memory. Containers of pointers never emit
+            // a count as pointers that can't be mapped are skipped.
+            EMIT_CONTAINER_COUNTS = 0x100,
         };
     };
 
@@ -169,6 +230,12 @@ namespace clutl
     CLCPP_API JSONError LoadJSON(ReadBuffer& in, void* object, const clcpp::Type* type, unsigned int transient_flags);
     CLCPP_API JSONError LoadJSON(JSONContext& ctx, void* object, const clcpp::Field* field, unsigned int transient_flags);
 
+    // Load an object of a given type from the source, streaming input in chunks of the given size as it's
+    // parsed instead of holding it all in memory. Arrays that need a counting pre-pass (see EMIT_CONTAINER_COUNTS)
+    // are held in memory while they're parsed.
+    CLCPP_API JSONError LoadJSON(IReadSource& source, void* object, const clcpp::Type* type, unsigned int transient_flags,
+                                 unsigned int chunk_size = 64 * 1024);
+
     // Save an object of a given type to the write buffer.
     // If ptr_save is null, no pointers are serialised.
     CLCPP_API void SaveJSON(WriteBuffer& out, const void* object, const clcpp::Type* type, IPtrMap* ptr_map, unsigned int flags,
@@ -178,4 +245,9 @@ namespace clutl
     // If ptr_save is null, no pointers are serialised.
     CLCPP_API void SaveJSON(WriteBuffer& out, const void* object, const clcpp::Field* field, IPtrMap* ptr_map, unsigned int flags,
                             unsigned int transient_flags);
+
+    // Save an object of a given type to the sink in chunks of the given size as they fill, so that only
+    // one chunk is ever held in memory. Returns false if the sink failed to write any of them.
+    CLCPP_API bool SaveJSON(IWriteSink& sink, const void* object, const clcpp::Type* type, IPtrMap* ptr_map, unsigned int flags,
+                            unsigned int transient_flags, unsigned int chunk_size = 64 * 1024);
 }
\ No newline at end of file
@@ -0,0 +1,187 @@
+//
+// ===============================================================================
+// clReflect
+// -------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 Don Williamson & clReflect Authors (see AUTHORS file)
+// Released under MIT License (see LICENSE file)
+// ===============================================================================
+//
+
+#include <clcpp/clcpp.h>
+#include <clcpp/clcpp_internal.h>
+
+
+//
+// A small, dependency-free LZ77 block codec using the LZ4 sequence layout:
+//
+//    token        4-bit literal count, 4-bit match length - MIN_MATCH
+//    [lengths]    literal count continuation bytes if the 4-bit count is 15
+//    literals
+//    offset       2-byte little-endian distance back to the match
+//    [lengths]    match length continuation bytes if the 4-bit length is 15
+//
+// The final sequence of a block has literals only and no offset.
+//
+namespace
+{
+    const unsigned int MIN_MATCH = 4;
+    const unsigned int MAX_OFFSET = 65535;
+    const unsigned int HASH_BITS = 12;
+
+    unsigned int Read32(const unsigned char* ptr)
+    {
+        return ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | ((unsigned int)ptr[3] << 24);
+    }
+
+    unsigned int HashSequence(unsigned int sequence)
+    {
+        return (sequence * 2654435761U) >> (32 - HASH_BITS);
+    }
+
+    unsigned char* WriteLength(unsigned char* dest, clcpp::size_type length)
+    {
+        while (length >= 255)
+        {
+            *dest++ = 255;
+            length -= 255;
+        }
+        *dest++ = (unsigned char)length;
+        return dest;
+    }
+
+    unsigned char* WriteSequence(unsigned char* dest, const unsigned char* literals, clcpp::size_type nb_literals,
+                                 clcpp::size_type offset, clcpp::size_type match_length)
+    {
+        // Pack the literal count and match length into the token
+        clcpp::size_type match_code = match_length ? match_length - MIN_MATCH : 0;
+        unsigned char* token = dest++;
+        *token = (unsigned char)(((nb_literals < 15 ? nb_literals : 15) << 4) | (match_code < 15 ? match_code : 15));
+
+        if (nb_literals >= 15)
+            dest = WriteLength(dest, nb_literals - 15);
+        for (clcpp::size_type i = 0; i < nb_literals; i++)
+            *dest++ = literals[i];
+
+        // The last sequence has no match
+        if (match_length != 0)
+        {
+            *dest++ = (unsigned char)(offset & 0xFF);
+            *dest++ = (unsigned char)(offset >> 8);
+            if (match_code >= 15)
+                dest = WriteLength(dest, match_code - 15);
+        }
+
+        return dest;
+    }
+
+    bool ReadLength(const unsigned char* src, clcpp::size_type src_size, clcpp::size_type& pos, clcpp::size_type& length)
+    {
+        unsigned char byte;
+        do
+        {
+            if (pos >= src_size)
+                return false;
+            byte = src[pos++];
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+}
+
+
+clcpp::size_type clcpp::internal::CompressBlockBound(size_type size)
+{
+    return size + size / 255 + 16;
+}
+
+
+clcpp::size_type clcpp::internal::CompressBlock(const void* src, size_type src_size, void* dest)
+{
+    const unsigned char* in = (const unsigned char*)src;
+    unsigned char* out = (unsigned char*)dest;
+
+    // Most recent position of each hashed 4-byte sequence
+    int table[1 << HASH_BITS];
+    for (unsigned int i = 0; i < (1 << HASH_BITS); i++)
+        table[i] = -1;
+
+    // Greedily take the first match found at each position
+    size_type pos = 0;
+    size_type anchor = 0;
+    while (pos + MIN_MATCH <= src_size)
+    {
+        unsigned int sequence = Read32(in + pos);
+        unsigned int hash = HashSequence(sequence);
+        int candidate = table[hash];
+        table[hash] = (int)pos;
+
+        if (candidate < 0 || pos - candidate > MAX_OFFSET || Read32(in + candidate) != sequence)
+        {
+            // Skip through incompressible data faster the longer it goes without a match
+            pos += 1 + ((pos - anchor) >> 6);
+            continue;
+        }
+
+        size_type match_length = MIN_MATCH;
+        while (pos + match_length < src_size && in[candidate + match_length] == in[pos + match_length])
+            match_length++;
+
+        out = WriteSequence(out, in + anchor, pos - anchor, pos - candidate, match_length);
+        pos += match_length;
+        anchor = pos;
+    }
+
+    // Emit any trailing literals
+    out = WriteSequence(out, in + anchor, src_size - anchor, 0, 0);
+    return out - (unsigned char*)dest;
+}
+
+
+bool clcpp::internal::DecompressBlock(const void* src, size_type src_size, void* dest, size_type dest_size)
+{
+    const unsigned char* in = (const unsigned char*)src;
+    unsigned char* out = (unsigned char*)dest;
+
+    // Every read and write is bounds-checked so that corrupt data can't overrun the output
+    size_type in_pos = 0;
+    size_type out_pos = 0;
+    while (in_pos < src_size)
+    {
+        unsigned char token = in[in_pos++];
+
+        // Copy literals
+        size_type nb_literals = token >> 4;
+        if (nb_literals == 15 && !ReadLength(in, src_size, in_pos, nb_literals))
+            return false;
+        if (nb_literals > src_size - in_pos || nb_literals > dest_size - out_pos)
+            return false;
+        for (size_type i = 0; i < nb_literals; i++)
+            out[out_pos++] = in[in_pos++];
+
+        // The last sequence ends with the block
+        if (in_pos == src_size)
+            break;
+
+        if (src_size - in_pos < 2)
+            return false;
+        size_type offset = in[in_pos] | (in[in_pos + 1] << 8);
+        in_pos += 2;
+        if (offset == 0 || offset > out_pos)
+            return false;
+
+        size_type match_length = token & 15;
+        if (match_length == 15 && !ReadLength(in, src_size, in_pos, match_length))
+            return false;
+        match_length += MIN_MATCH;
+        if (match_length > dest_size - out_pos)
+            return false;
+
+        // Copy forwards one byte at a time as the match may overlap the output
+        const unsigned char* match = out + out_pos - offset;
+        for (size_type i = 0; i < match_length; i++)
+            out[out_pos + i] = match[i];
+        out_pos += match_length;
+    }
+
+    return out_pos == dest_size;
+}
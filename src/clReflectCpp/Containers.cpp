@@ -62,6 +62,14 @@ public:
 		m_Position += m_ElementSize;
 	}
 
+	bool GetContiguous(clcpp::ContainerSpan& span) const
+	{
+		span.data = (void*)(m_ArrayData + m_Position);
+		span.count = (unsigned int)((m_Size - m_Position) / m_ElementSize);
+		span.stride = m_ElementSize;
+		return true;
+	}
+
 private:
 	// Construction values
 	const char* m_ArrayData;
@@ -123,6 +131,17 @@ public:
 		return AddEmpty();
 	}
 
+	bool AddEmptyRange(unsigned int count, clcpp::ContainerSpan& span)
+	{
+		// Hand out as many of the requested values as there is storage left for
+		unsigned int nb_left = (unsigned int)((m_Size - m_Position) / m_ElementSize);
+		span.data = m_ArrayData + m_Position;
+		span.count = count < nb_left ? count : nb_left;
+		span.stride = m_ElementSize;
+		m_Position += span.count * m_ElementSize;
+		return true;
+	}
+
 private:
 	// Construction values
 	char* m_ArrayData;
@@ -213,6 +232,17 @@ void clcpp::WriteIterator::Initialise(const Type* type, void* container_object,
 	clcpp::internal::Assert(m_IteratorImplType->size < sizeof(m_ImplData));
 	CallFunction(m_IteratorImplType->constructor, (IWriteIterator*)m_ImplData);
 
+	// Containers of unknown size can only be written if they grow as values are added
+	if (count < 0)
+	{
+		if (!((IWriteIterator*)m_ImplData)->CanGrow())
+		{
+			CallFunction(m_IteratorImplType->destructor, (IWriteIterator*)m_ImplData);
+			return;
+		}
+		count = 0;
+	}
+
 	// Complete implementation-specific initialisation
 	((IWriteIterator*)m_ImplData)->Initialise(type, container_object, *this, count);
 	m_Initialised = true;
@@ -0,0 +1,178 @@
+//
+// ===============================================================================
+// clReflect
+// -------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 Don Williamson & clReflect Authors (see AUTHORS file)
+// Released under MIT License (see LICENSE file)
+// ===============================================================================
+//
+
+#include <clcpp/DatabaseHandle.h>
+
+#if defined(CLCPP_USING_MSVC)
+    #include <intrin.h>
+#endif
+
+
+namespace
+{
+    // Sequentially consistent atomics, without depending on the C++ runtime
+
+#if defined(CLCPP_USING_MSVC)
+
+    unsigned int AtomicLoad(volatile unsigned int* ptr)
+    {
+        return (unsigned int)_InterlockedCompareExchange((volatile long*)ptr, 0, 0);
+    }
+    void AtomicStore(volatile unsigned int* ptr, unsigned int value)
+    {
+        _InterlockedExchange((volatile long*)ptr, (long)value);
+    }
+    unsigned int AtomicIncrement(volatile unsigned int* ptr)
+    {
+        return (unsigned int)_InterlockedIncrement((volatile long*)ptr);
+    }
+    bool AtomicCompareExchange(volatile unsigned int* ptr, unsigned int expected, unsigned int value)
+    {
+        return (unsigned int)_InterlockedCompareExchange((volatile long*)ptr, (long)value, (long)expected) == expected;
+    }
+    clcpp::Database* AtomicLoad(clcpp::Database* volatile* ptr)
+    {
+        return (clcpp::Database*)_InterlockedCompareExchangePointer((void* volatile*)ptr, 0, 0);
+    }
+    clcpp::Database* AtomicExchange(clcpp::Database* volatile* ptr, clcpp::Database* value)
+    {
+        return (clcpp::Database*)_InterlockedExchangePointer((void* volatile*)ptr, value);
+    }
+
+#else
+
+    unsigned int AtomicLoad(volatile unsigned int* ptr)
+    {
+        return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+    }
+    void AtomicStore(volatile unsigned int* ptr, unsigned int value)
+    {
+        __atomic_store_n(ptr, value, __ATOMIC_SEQ_CST);
+    }
+    unsigned int AtomicIncrement(volatile unsigned int* ptr)
+    {
+        return __atomic_add_fetch(ptr, 1, __ATOMIC_SEQ_CST);
+    }
+    bool AtomicCompareExchange(volatile unsigned int* ptr, unsigned int expected, unsigned int value)
+    {
+        return __atomic_compare_exchange_n(ptr, &expected, value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    }
+    clcpp::Database* AtomicLoad(clcpp::Database* volatile* ptr)
+    {
+        return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+    }
+    clcpp::Database* AtomicExchange(clcpp::Database* volatile* ptr, clcpp::Database* value)
+    {
+        return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST);
+    }
+
+#endif
+}
+
+
+clcpp::DatabaseHandle::DatabaseHandle()
+    : m_Database(0)
+    , m_Epoch(1)
+    , m_NbRetired(0)
+{
+    for (unsigned int i = 0; i < MAX_READERS; i++)
+    {
+        m_ReaderUsed[i] = 0;
+        m_ReaderEpochs[i] = 0;
+    }
+}
+
+
+unsigned int clcpp::DatabaseHandle::AddReader()
+{
+    // Claim the first free slot, which may have been released by a reader that has since exited
+    for (unsigned int i = 0; i < MAX_READERS; i++)
+    {
+        if (AtomicCompareExchange(&m_ReaderUsed[i], 0, 1))
+            return i;
+    }
+
+    internal::Assert(false && "Too many database readers");
+    return MAX_READERS;
+}
+
+
+void clcpp::DatabaseHandle::RemoveReader(unsigned int reader)
+{
+    internal::Assert(reader < MAX_READERS);
+    internal::Assert(m_ReaderEpochs[reader] == 0 && "Can't remove a reader while it's reading");
+    AtomicStore(&m_ReaderUsed[reader], 0);
+}
+
+
+const clcpp::Database* clcpp::DatabaseHandle::BeginRead(unsigned int reader)
+{
+    internal::Assert(reader < MAX_READERS);
+    internal::Assert(m_ReaderEpochs[reader] == 0 && "Database reads can't be nested");
+
+    // Publish the epoch before reading the database pointer. If a swap happens in between, this
+    // reader sees the new database; otherwise the writer sees this epoch and keeps the old one.
+    AtomicStore(&m_ReaderEpochs[reader], AtomicLoad(&m_Epoch));
+    return AtomicLoad(&m_Database);
+}
+
+
+void clcpp::DatabaseHandle::EndRead(unsigned int reader)
+{
+    internal::Assert(reader < MAX_READERS);
+    AtomicStore(&m_ReaderEpochs[reader], 0);
+}
+
+
+bool clcpp::DatabaseHandle::Swap(Database* database)
+{
+    if (m_NbRetired == MAX_RETIRED)
+        return false;
+
+    // Any reader that started in this epoch or earlier may have the old database
+    Database* old_database = AtomicExchange(&m_Database, database);
+    unsigned int epoch = AtomicLoad(&m_Epoch);
+    AtomicIncrement(&m_Epoch);
+
+    if (old_database != 0)
+    {
+        m_Retired[m_NbRetired].database = old_database;
+        m_Retired[m_NbRetired].epoch = epoch;
+        m_NbRetired++;
+    }
+
+    return true;
+}
+
+
+clcpp::Database* clcpp::DatabaseHandle::Reclaim()
+{
+    // Find the oldest epoch that any reader is still in
+    // Free slots always have a zero epoch
+    unsigned int oldest_epoch = AtomicLoad(&m_Epoch);
+    for (unsigned int i = 0; i < MAX_READERS; i++)
+    {
+        unsigned int epoch = AtomicLoad(&m_ReaderEpochs[i]);
+        if (epoch != 0 && epoch < oldest_epoch)
+            oldest_epoch = epoch;
+    }
+
+    // Hand back any database retired before then
+    for (unsigned int i = 0; i < m_NbRetired; i++)
+    {
+        if (m_Retired[i].epoch < oldest_epoch)
+        {
+            Database* database = m_Retired[i].database;
+            m_Retired[i] = m_Retired[--m_NbRetired];
+            return database;
+        }
+    }
+
+    return 0;
+}
@@ -24,8 +24,56 @@ extern "C" void* dlsym(void* handle, const char* name);
     #endif
 #endif
 
+#if defined(CLCPP_USING_MSVC)
+    #include <intrin.h>
+#endif
+
+#if defined(CLCPP_USING_GNUC)
+    #define CLCPP_PREFETCH(address) __builtin_prefetch(address)
+#elif defined(CLCPP_USING_MSVC) && (defined(_M_IX86) || defined(_M_X64))
+    #include <xmmintrin.h>
+    #define CLCPP_PREFETCH(address) _mm_prefetch((const char*)(address), _MM_HINT_T0)
+#else
+    #define CLCPP_PREFETCH(address)
+#endif
+
 namespace
 {
+    // Sequentially consistent atomics for loading sections from concurrent readers, without
+    // depending on the C++ runtime
+
+#if defined(CLCPP_USING_MSVC)
+
+    unsigned int AtomicLoad(const volatile unsigned int* ptr)
+    {
+        return (unsigned int)_InterlockedCompareExchange((volatile long*)ptr, 0, 0);
+    }
+    void AtomicStore(volatile unsigned int* ptr, unsigned int value)
+    {
+        _InterlockedExchange((volatile long*)ptr, (long)value);
+    }
+    bool AtomicCompareExchange(volatile unsigned int* ptr, unsigned int expected, unsigned int value)
+    {
+        return (unsigned int)_InterlockedCompareExchange((volatile long*)ptr, (long)value, (long)expected) == expected;
+    }
+
+#else
+
+    unsigned int AtomicLoad(const volatile unsigned int* ptr)
+    {
+        return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+    }
+    void AtomicStore(volatile unsigned int* ptr, unsigned int value)
+    {
+        __atomic_store_n(ptr, value, __ATOMIC_SEQ_CST);
+    }
+    bool AtomicCompareExchange(volatile unsigned int* ptr, unsigned int expected, unsigned int value)
+    {
+        return __atomic_compare_exchange_n(ptr, &expected, value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    }
+
+#endif
+
     struct PtrSchema
     {
         size_t stride;
@@ -107,6 +155,12 @@ namespace
         return h1;
     }
 
+    void memcpy(void* dest, const void* src, clcpp::size_type size)
+    {
+        for (clcpp::size_type i = 0; i < size; i++)
+            ((char*)dest)[i] = ((const char*)src)[i];
+    }
+
     int strlen(const char* str)
     {
         int len = 0;
@@ -161,6 +215,94 @@ namespace
         return -1;
     }
 
+    int HashArraySearch(const clcpp::CArray<unsigned int>& hashes, unsigned int compare_hash)
+    {
+        if (hashes.size == 0)
+            return -1;
+
+        // Branchless lower bound that only reads the packed hash array; the loop trip count
+        // depends only on the array size so there are no mispredicted compares
+        const unsigned int* base = hashes.data;
+        unsigned int n = hashes.size;
+        while (n > 1)
+        {
+            unsigned int half = n / 2;
+            base = base[half - 1] < compare_hash ? base + half : base;
+            n -= half;
+        }
+
+        int index = (int)(base - hashes.data) + (*base < compare_hash);
+        if (index < (int)hashes.size && hashes.data[index] == compare_hash)
+            return index;
+        return -1;
+    }
+
+    template <typename ARRAY_TYPE, typename COMPARE_L_TYPE, unsigned int(GET_HASH_FUNC)(COMPARE_L_TYPE)>
+    int HashSearch(const clcpp::CArray<clcpp::internal::HashIndexSlot>& hash_index,
+                   const clcpp::CArray<ARRAY_TYPE>& entries, unsigned int compare_hash)
+    {
+        // Fall back to a binary search if there is no index
+        if (hash_index.size == 0)
+            return BinarySearch<ARRAY_TYPE, COMPARE_L_TYPE, GET_HASH_FUNC>(entries, compare_hash);
+
+        // Linear probe from the home slot until either the hash or an empty slot is found. The
+        // table is never more than half full so this is expected to touch one cache line. Empty
+        // slots are tested first as they have a hash of zero, which is never a valid name.
+        unsigned int mask = hash_index.size - 1;
+        for (unsigned int i = compare_hash & mask;; i = (i + 1) & mask)
+        {
+            const clcpp::internal::HashIndexSlot& slot = hash_index.data[i];
+            if (slot.hash == 0)
+                return -1;
+            if (slot.hash == compare_hash)
+                return slot.index;
+        }
+    }
+
+    // Number of keys in flight at once during a batched search
+    const unsigned int HASH_SEARCH_BATCH_SIZE = 16;
+
+    template <typename ARRAY_TYPE, typename COMPARE_L_TYPE, unsigned int(GET_HASH_FUNC)(COMPARE_L_TYPE)>
+    void HashSearchBatch(const clcpp::CArray<clcpp::internal::HashIndexSlot>& hash_index,
+                         const clcpp::CArray<ARRAY_TYPE>& entries, const unsigned int* compare_hashes,
+                         unsigned int nb_hashes, int* out_indices)
+    {
+        clcpp::internal::Assert(nb_hashes <= HASH_SEARCH_BATCH_SIZE);
+
+        if (hash_index.size == 0)
+        {
+            for (unsigned int i = 0; i < nb_hashes; i++)
+                out_indices[i] = BinarySearch<ARRAY_TYPE, COMPARE_L_TYPE, GET_HASH_FUNC>(entries, compare_hashes[i]);
+            return;
+        }
+
+        // Touch the home slot of every key before probing any of them so that the cache misses
+        // of independent keys overlap, rather than being paid one after the other
+        unsigned int mask = hash_index.size - 1;
+        for (unsigned int i = 0; i < nb_hashes; i++)
+            CLCPP_PREFETCH(hash_index.data + (compare_hashes[i] & mask));
+
+        // Probe and prefetch the entries that will be returned to the caller
+        for (unsigned int i = 0; i < nb_hashes; i++)
+        {
+            unsigned int compare_hash = compare_hashes[i];
+            int index = -1;
+            for (unsigned int j = compare_hash & mask;; j = (j + 1) & mask)
+            {
+                const clcpp::internal::HashIndexSlot& slot = hash_index.data[j];
+                if (slot.hash == 0)
+                    break;
+                if (slot.hash == compare_hash)
+                {
+                    index = slot.index;
+                    CLCPP_PREFETCH(entries.data + index);
+                    break;
+                }
+            }
+            out_indices[i] = index;
+        }
+    }
+
     template <typename ARRAY_TYPE, typename COMPARE_L_TYPE, unsigned int(GET_HASH_FUNC)(COMPARE_L_TYPE)>
     clcpp::Range SearchNeighbours(const clcpp::CArray<ARRAY_TYPE>& entries, unsigned int compare_hash, int index)
     {
@@ -177,104 +319,370 @@ namespace
         return range;
     }
 
-    template <typename TYPE>
-    bool ReadArray(clcpp::IFile* file, clcpp::CArray<TYPE>& array, unsigned int size, clcpp::IAllocator* allocator)
+    clcpp::Range SearchHashNeighbours(const clcpp::CArray<unsigned int>& hashes, unsigned int compare_hash, int index)
+    {
+        clcpp::Range range;
+        range.first = index;
+        range.last = index + 1;
+
+        // As above, only touching the packed hash array
+        while (range.first > 0 && hashes[range.first - 1] == compare_hash)
+            range.first--;
+        while (range.last < hashes.size && hashes[range.last] == compare_hash)
+            range.last++;
+
+        return range;
+    }
+
+    bool VerifyFileHeader(const clcpp::internal::DatabaseFileHeader& file_header)
+    {
+        // Compare the version and signature against those of the running code
+        clcpp::internal::DatabaseFileHeader cmp_header;
+        if (file_header.version != cmp_header.version)
+            return false;
+        if (file_header.signature0 != cmp_header.signature0 || file_header.signature1 != cmp_header.signature1)
+            return false;
+        return true;
+    }
+
+    // Relocation work is only handed out to a job runner in chunks of at least this many pointers
+    const size_t MIN_RELOCATION_JOB_PTRS = 16 * 1024;
+    const unsigned int MAX_RELOCATION_JOBS = 64;
+
+    struct RelocationJobStart
     {
-        // Allocate space for the data
-        array.size = size;
-        array.data = (TYPE*)allocator->Alloc(size * sizeof(TYPE));
+        int relocation;
+        int object;
+    };
 
-        // Read from the file, deleting on failure
-        if (!file->Read((void*)array.data, array.size * sizeof(TYPE)))
+    struct RelocationJobs
+    {
+        char* base_data;
+        const PtrSchema* schemas;
+        const size_t* ptr_offsets;
+        const PtrRelocation* relocations;
+        int nb_relocations;
+        size_t prelink_address;
+        size_t data_size;
+        size_t delta;
+
+        // Each job patches the objects between its start and the start of the next job
+        unsigned int nb_jobs;
+        RelocationJobStart job_starts[MAX_RELOCATION_JOBS + 1];
+    };
+
+    size_t RelocatePointer(size_t& ptr, size_t prelink_address, size_t delta, size_t data_size)
+    {
+        // Patch non-null pointers without branching, returning non-zero if the pointer is outside
+        // the memory map
+        size_t mask = 0 - (size_t)(ptr != 0);
+        size_t out_of_range = mask & (size_t)(ptr - prelink_address > data_size);
+        ptr += delta & mask;
+        return out_of_range;
+    }
+
+    size_t RelocateObjects(const RelocationJobs& jobs, const PtrRelocation& reloc, int first_object, int end_object)
+    {
+        const PtrSchema& schema = jobs.schemas[reloc.schema_handle];
+        size_t prelink_address = jobs.prelink_address;
+        size_t data_size = jobs.data_size;
+        size_t delta = jobs.delta;
+
+        // Take a weak pointer to the schema's pointer offsets
+        const size_t* schema_ptr_offsets = jobs.ptr_offsets + schema.ptrs_offset;
+        char* objects = jobs.base_data + reloc.offset + (size_t)first_object * schema.stride;
+        size_t out_of_range = 0;
+
+        // Contiguous arrays of pointers, such as the global type list, are patched with one tight loop
+        if (schema.stride == sizeof(size_t) && schema.nb_ptrs == 1 && schema_ptr_offsets[0] == 0)
         {
-            allocator->Free(array.data);
+            size_t* ptrs = (size_t*)objects;
+            for (int j = 0; j < end_object - first_object; j++)
+                out_of_range |= RelocatePointer(ptrs[j], prelink_address, delta, data_size);
+            return out_of_range;
+        }
+
+        // Iterate over all objects in the instruction, patching all pointers in the schema
+        for (int j = 0; j < end_object - first_object; j++)
+        {
+            char* object = objects + (size_t)j * schema.stride;
+            for (size_t k = 0; k < schema.nb_ptrs; k++)
+                out_of_range |= RelocatePointer((size_t&)*(object + schema_ptr_offsets[k]), prelink_address, delta, data_size);
+        }
+
+        return out_of_range;
+    }
+
+    void RunRelocationJob(void* job_data, unsigned int job_index)
+    {
+        const RelocationJobs& jobs = *(const RelocationJobs*)job_data;
+        const RelocationJobStart& start = jobs.job_starts[job_index];
+        const RelocationJobStart& end = jobs.job_starts[job_index + 1];
+
+        // Patch the tail of the first relocation instruction, up to the head of the last
+        size_t out_of_range = 0;
+        for (int i = start.relocation; i <= end.relocation && i < jobs.nb_relocations; i++)
+        {
+            const PtrRelocation& reloc = jobs.relocations[i];
+            int first_object = i == start.relocation ? start.object : 0;
+            int end_object = i == end.relocation ? end.object : reloc.nb_objects;
+            out_of_range |= RelocateObjects(jobs, reloc, first_object, end_object);
+        }
+
+        // Ensure all pointer relocations were within range of the memory map
+        clcpp::internal::Assert(out_of_range == 0);
+    }
+
+    void SplitRelocationJobs(RelocationJobs& jobs)
+    {
+        // Count the total number of pointers to patch
+        size_t nb_ptrs = 0;
+        for (int i = 0; i < jobs.nb_relocations; i++)
+        {
+            const PtrRelocation& reloc = jobs.relocations[i];
+            nb_ptrs += (size_t)reloc.nb_objects * jobs.schemas[reloc.schema_handle].nb_ptrs;
+        }
+
+        jobs.nb_jobs = (unsigned int)(nb_ptrs / MIN_RELOCATION_JOB_PTRS);
+        jobs.nb_jobs = jobs.nb_jobs < 1 ? 1 : jobs.nb_jobs > MAX_RELOCATION_JOBS ? MAX_RELOCATION_JOBS : jobs.nb_jobs;
+
+        // Split at object granularity so that large arrays can be shared between jobs. Each job
+        // starts at the object containing its share of the total pointer count.
+        jobs.job_starts[0].relocation = 0;
+        jobs.job_starts[0].object = 0;
+        unsigned int job_index = 1;
+        size_t ptr_index = 0;
+        for (int i = 0; i < jobs.nb_relocations; i++)
+        {
+            const PtrRelocation& reloc = jobs.relocations[i];
+            size_t nb_schema_ptrs = jobs.schemas[reloc.schema_handle].nb_ptrs;
+            size_t nb_reloc_ptrs = (size_t)reloc.nb_objects * nb_schema_ptrs;
+            while (job_index < jobs.nb_jobs && nb_ptrs * job_index / jobs.nb_jobs < ptr_index + nb_reloc_ptrs)
+            {
+                size_t job_ptr_index = nb_ptrs * job_index / jobs.nb_jobs;
+                jobs.job_starts[job_index].relocation = i;
+                jobs.job_starts[job_index].object = (int)((job_ptr_index - ptr_index) / nb_schema_ptrs);
+                job_index++;
+            }
+            ptr_index += nb_reloc_ptrs;
+        }
+
+        jobs.job_starts[jobs.nb_jobs].relocation = jobs.nb_relocations;
+        jobs.job_starts[jobs.nb_jobs].object = 0;
+    }
+
+    clcpp::size_type GetRelocationDataSize(const clcpp::internal::DatabaseFileHeader& file_header)
+    {
+        return file_header.nb_ptr_schemas * sizeof(PtrSchema) + file_header.nb_ptr_offsets * sizeof(size_t) +
+               file_header.nb_ptr_relocations * sizeof(PtrRelocation);
+    }
+
+    bool ConsumeArray(clcpp::size_type& available, int count, clcpp::size_type element_size)
+    {
+        // Divide rather than multiply so that counts from a corrupt header can't overflow
+        if (count < 0 || (clcpp::size_type)count > available / element_size)
+            return false;
+        available -= count * element_size;
+        return true;
+    }
+
+    bool RelocationDataFits(const clcpp::internal::DatabaseFileHeader& file_header, clcpp::size_type available)
+    {
+        if (!ConsumeArray(available, file_header.nb_ptr_schemas, sizeof(PtrSchema)) ||
+            !ConsumeArray(available, file_header.nb_ptr_offsets, sizeof(size_t)) ||
+            !ConsumeArray(available, file_header.nb_ptr_relocations, sizeof(PtrRelocation)))
             return false;
+
+        // Sections index into the relocation instructions
+        int nb_relocations = 0;
+        for (int i = 0; i < clcpp::Database::NB_SECTIONS; i++)
+        {
+            int nb_section_relocations = file_header.nb_section_ptr_relocations[i];
+            if (nb_section_relocations < 0 || nb_section_relocations > file_header.nb_ptr_relocations - nb_relocations)
+                return false;
+            nb_relocations += nb_section_relocations;
         }
 
         return true;
     }
 
-    clcpp::internal::DatabaseMem* LoadMemoryMappedDatabase(clcpp::IFile* file, clcpp::IAllocator* allocator)
+    void RelocatePointers(char* base_data, const clcpp::internal::DatabaseFileHeader& file_header,
+                          const char* relocation_data, int first_relocation, int nb_relocations,
+                          clcpp::IJobRunner* job_runner)
+    {
+        // Pointers are stored relative to the prelink address so there's nothing to do if the data
+        // has been loaded there
+        RelocationJobs jobs;
+        jobs.delta = (size_t)base_data - (size_t)file_header.prelink_address;
+        if (jobs.delta == 0 || nb_relocations == 0)
+            return;
+
+        // The schemas, their pointer offsets and the relocation instructions follow each other
+        jobs.base_data = base_data;
+        jobs.schemas = (const PtrSchema*)relocation_data;
+        jobs.ptr_offsets = (const size_t*)(jobs.schemas + file_header.nb_ptr_schemas);
+        jobs.relocations = (const PtrRelocation*)(jobs.ptr_offsets + file_header.nb_ptr_offsets) + first_relocation;
+        jobs.nb_relocations = nb_relocations;
+        jobs.prelink_address = (size_t)file_header.prelink_address;
+        jobs.data_size = file_header.data_size;
+
+        // Relocation instructions patch disjoint pointers so they can be safely run in parallel
+        if (job_runner == 0)
+        {
+            jobs.nb_jobs = 1;
+            jobs.job_starts[0].relocation = 0;
+            jobs.job_starts[0].object = 0;
+            jobs.job_starts[1].relocation = nb_relocations;
+            jobs.job_starts[1].object = 0;
+            RunRelocationJob(&jobs, 0);
+            return;
+        }
+
+        SplitRelocationJobs(jobs);
+        job_runner->Run(RunRelocationJob, &jobs, jobs.nb_jobs);
+    }
+
+    bool ReadDatabaseData(clcpp::IFile* file, clcpp::IAllocator* allocator,
+                          const clcpp::internal::DatabaseFileHeader& file_header, char* base_data,
+                          clcpp::size_type data_size)
+    {
+        if (file_header.compression_block_size == 0)
+            return file->Read(base_data, data_size);
+
+        // Stream each compressed block through a scratch buffer straight into the allocation
+        clcpp::size_type block_bound = clcpp::internal::CompressBlockBound(file_header.compression_block_size);
+        char* block_data = (char*)allocator->Alloc(block_bound);
+        bool success = true;
+        for (clcpp::size_type offset = 0; success && offset < data_size;)
+        {
+            clcpp::size_type block_size = data_size - offset;
+            if (block_size > file_header.compression_block_size)
+                block_size = file_header.compression_block_size;
+
+            // Raw blocks are read directly, without the scratch buffer
+            unsigned int compressed_size;
+            success = file->Read(&compressed_size, sizeof(compressed_size));
+            if (success && (compressed_size & clcpp::internal::COMPRESSED_BLOCK_STORED))
+                success = (compressed_size & ~clcpp::internal::COMPRESSED_BLOCK_STORED) == block_size &&
+                          file->Read(base_data + offset, block_size);
+            else if (success)
+                success = compressed_size <= block_bound && file->Read(block_data, compressed_size) &&
+                          clcpp::internal::DecompressBlock(block_data, compressed_size, base_data + offset, block_size);
+
+            offset += block_size;
+        }
+
+        allocator->Free(block_data);
+        return success;
+    }
+
+    clcpp::internal::DatabaseMem* ReadDatabase(clcpp::IFile* file, clcpp::IAllocator* allocator,
+                                               clcpp::internal::DatabaseFileHeader*& out_file_header)
     {
         // Read the header and verify the version and signature
-        clcpp::internal::DatabaseFileHeader file_header, cmp_header;
-        
+        clcpp::internal::DatabaseFileHeader file_header;
         if (!file->Read(&file_header, sizeof(file_header)))
             return 0;
-        if (file_header.version != cmp_header.version)
-            return 0;
-        if (file_header.signature0 != cmp_header.signature0 || file_header.signature1 != cmp_header.signature1)
+        if (!VerifyFileHeader(file_header))
             return 0;
 
-        // Read the memory mapped data
+        // Compact name text is left out of the file so read the stored data after the space it
+        // needs, moving the data that preceded it back down into place
+        if (file_header.name_text_offset > file_header.data_size ||
+            file_header.name_text_size > file_header.data_size - file_header.name_text_offset)
+            return 0;
         char* base_data = (char*)allocator->Alloc(file_header.data_size);
-        clcpp::internal::DatabaseMem* database_mem = (clcpp::internal::DatabaseMem*)base_data;
-        if (!file->Read(base_data, file_header.data_size))
+        char* stored_data = base_data + file_header.name_text_size;
+        if (!ReadDatabaseData(file, allocator, file_header, stored_data, file_header.data_size - file_header.name_text_size))
+        {
+            allocator->Free(base_data);
             return 0;
-
-        // Read the schema descriptions
-        clcpp::CArray<PtrSchema> schemas;
-        if (!ReadArray(file, schemas, file_header.nb_ptr_schemas, allocator))
+        }
+        memcpy(base_data, stored_data, file_header.name_text_offset);
+
+        // Read the schema descriptions, their pointer offsets and the pointer relocation
+        // instructions, which are kept after a copy of the header until all pointers are patched
+        clcpp::size_type relocation_data_size = GetRelocationDataSize(file_header);
+        char* relocation_data = (char*)allocator->Alloc(sizeof(file_header) + relocation_data_size);
+        memcpy(relocation_data, &file_header, sizeof(file_header));
+        if (!file->Read(relocation_data + sizeof(file_header), relocation_data_size))
+        {
+            allocator->Free(relocation_data);
+            allocator->Free(base_data);
             return 0;
+        }
 
-        // Read the pointer offsets for all the schemas
-        clcpp::CArray<size_t> ptr_offsets;
-        if (!ReadArray(file, ptr_offsets, file_header.nb_ptr_offsets, allocator))
-            return 0;
+        out_file_header = (clcpp::internal::DatabaseFileHeader*)relocation_data;
+        return (clcpp::internal::DatabaseMem*)base_data;
+    }
 
-        // Read the pointer relocation instructions
-        clcpp::CArray<PtrRelocation> relocations;
-        if (!ReadArray(file, relocations, file_header.nb_ptr_relocations, allocator))
+    clcpp::internal::DatabaseMem* MapDatabase(void* data, clcpp::size_type size)
+    {
+        // Copy the header out of the map as there are no alignment guarantees on the source
+        clcpp::internal::DatabaseFileHeader file_header;
+        if (data == 0 || size < sizeof(file_header))
+            return 0;
+        memcpy(&file_header, data, sizeof(file_header));
+        if (!VerifyFileHeader(file_header))
             return 0;
 
-        // Iterate over every relocation instruction
-        for (int i = 0; i < file_header.nb_ptr_relocations; i++)
-        {
-            PtrRelocation& reloc = static_cast<PtrRelocation&>(relocations[i]);
-            PtrSchema& schema = static_cast<PtrSchema&>(schemas[reloc.schema_handle]);
-
-            // Take a weak C-array pointer to the schema's pointer offsets (for bounds checking)
-            clcpp::CArray<size_t> schema_ptr_offsets;
-            schema_ptr_offsets.data = (size_t*)&ptr_offsets[schema.ptrs_offset];
-            schema_ptr_offsets.size = (unsigned int)schema.nb_ptrs;
-
-            // Iterate over all objects in the instruction
-            for (int j = 0; j < reloc.nb_objects; j++)
-            {
-                size_t object_offset = reloc.offset + (size_t)j * schema.stride;
-
-                // All pointers in the schema
-                for (size_t k = 0; k < schema.nb_ptrs; k++)
-                {
-                    size_t ptr_offset = object_offset + schema_ptr_offsets[k];
-                    size_t& ptr = (size_t&)*(base_data + ptr_offset);
-
-                    // Ensure the pointer relocation is within range of the memory map before patching
-                    clcpp::internal::Assert(ptr <= file_header.data_size);
+        // Compressed databases and those with compact names can't be used in-place
+        if (file_header.compression_block_size != 0 || file_header.name_text_size != 0)
+            return 0;
 
-                    // Only patch non-null
-                    if (ptr != 0)
-                        ptr += (size_t)base_data;
-                }
-            }
-        }
-        
-        // Release temporary array memory
-        allocator->Free(relocations.data);
-        allocator->Free(ptr_offsets.data);
-        allocator->Free(schemas.data);
+        // Ensure the map contains everything the header says is there before touching any of it
+        clcpp::size_type available = size - sizeof(file_header);
+        if (file_header.data_size > available || !RelocationDataFits(file_header, available - file_header.data_size))
+            return 0;
 
-        return database_mem;
+        // Pointers are patched in-place. Memory that contains no pointers, such as the name and
+        // text attribute data, is never written to and remains shared with the backing file.
+        // If the file has been mapped at its prelink address, nothing is written at all.
+        return (clcpp::internal::DatabaseMem*)((char*)data + sizeof(file_header));
     }
 
-    void RebaseFunctions(clcpp::internal::DatabaseMem& dbmem, clcpp::pointer_type base_address)
+    void RebaseFunctions(clcpp::internal::DatabaseMem& dbmem, clcpp::pointer_type from_address,
+                         clcpp::pointer_type base_address)
     {
         // Move all function addresses from their current location to their new location
         for (unsigned int i = 0; i < dbmem.functions.size; i++)
         {
             clcpp::Function& f = (clcpp::Function&)dbmem.functions[i];
             if (f.address)
-                f.address = f.address - dbmem.function_base_address + base_address;
+                f.address = f.address - from_address + base_address;
+        }
+    }
+
+    clcpp::size_type GetCompactNameLength(const clcpp::internal::DatabaseMem& dbmem, int index)
+    {
+        clcpp::size_type length = 0;
+        for (; index != -1; index = dbmem.compact_names[index].parent)
+            length += strlen(dbmem.compact_name_suffix_data + dbmem.compact_names[index].suffix_offset);
+        return length;
+    }
+
+    void WriteCompactName(const clcpp::internal::DatabaseMem& dbmem, int index, char* dest, clcpp::size_type length)
+    {
+        // Walk up the prefix names, writing each suffix backwards from the end of the text
+        dest[length] = 0;
+        for (; index != -1; index = dbmem.compact_names[index].parent)
+        {
+            const char* suffix = dbmem.compact_name_suffix_data + dbmem.compact_names[index].suffix_offset;
+            int suffix_length = strlen(suffix);
+            length -= suffix_length;
+            memcpy(dest + length, suffix, suffix_length);
+        }
+    }
+
+    void RebuildNameText(clcpp::internal::DatabaseMem& dbmem)
+    {
+        // Name text is laid out in the same order as the name array
+        char* text = (char*)dbmem.name_text_data;
+        for (unsigned int i = 0; i < dbmem.compact_names.size; i++)
+        {
+            clcpp::size_type length = GetCompactNameLength(dbmem, i);
+            WriteCompactName(dbmem, i, text, length);
+            text += length + 1;
         }
     }
 
@@ -287,6 +695,49 @@ namespace
         }
     }
 
+    void InitialiseLoadedSection(clcpp::Database* database, clcpp::internal::DatabaseMem& dbmem, unsigned int section,
+                                 clcpp::pointer_type base_address, unsigned int options)
+    {
+        // Rebasing functions is required mainly for DLLs and executables that run under Windows 7
+        // using its Address Space Layout Randomisation security feature. This is done with the core
+        // section as constructors and destructors of classes can be called without loading the rest
+        // of the functions section.
+        if (section == clcpp::Database::SECTION_CORE && (options & clcpp::Database::OPT_DONT_REBASE_FUNCTIONS) == 0)
+            RebaseFunctions(dbmem, dbmem.function_base_address, base_address);
+
+        if (section == clcpp::Database::SECTION_NAME_TEXT)
+            RebuildNameText(dbmem);
+
+        if (options & clcpp::Database::OPT_DONT_PARENT_PRIMITIVES)
+            return;
+
+        // Tell each loaded primitive that they belong to this database
+        switch (section)
+        {
+        case clcpp::Database::SECTION_CORE:
+            // Functions are reachable from classes so are parented here too, allowing the rest of
+            // their section to be loaded through them
+            ParentPrimitivesToDatabase(dbmem.functions, database);
+            ParentPrimitivesToDatabase(dbmem.types, database);
+            ParentPrimitivesToDatabase(dbmem.enum_constants, database);
+            ParentPrimitivesToDatabase(dbmem.enums, database);
+            ParentPrimitivesToDatabase(dbmem.fields, database);
+            ParentPrimitivesToDatabase(dbmem.classes, database);
+            ParentPrimitivesToDatabase(dbmem.templates, database);
+            ParentPrimitivesToDatabase(dbmem.template_types, database);
+            ParentPrimitivesToDatabase(dbmem.namespaces, database);
+            break;
+
+        case clcpp::Database::SECTION_ATTRIBUTES:
+            ParentPrimitivesToDatabase(dbmem.flag_attributes, database);
+            ParentPrimitivesToDatabase(dbmem.int_attributes, database);
+            ParentPrimitivesToDatabase(dbmem.float_attributes, database);
+            ParentPrimitivesToDatabase(dbmem.primitive_attributes, database);
+            ParentPrimitivesToDatabase(dbmem.text_attributes, database);
+            break;
+        }
+    }
+
     clcpp::pointer_type GetLoadAddress()
     {
     #if defined(CLCPP_PLATFORM_WINDOWS)
@@ -458,21 +909,8 @@ clcpp::Type::Type(Kind k)
 
 bool clcpp::Type::DerivesFrom(unsigned int type_name_hash) const
 {
-    // Search in immediate bases
-    for (unsigned int i = 0; i < base_types.size; i++)
-    {
-        if (base_types[i]->name.hash == type_name_hash)
-            return true;
-    }
-
-    // Search up the inheritance tree
-    for (unsigned int i = 0; i < base_types.size; i++)
-    {
-        if (base_types[i]->DerivesFrom(type_name_hash))
-            return true;
-    }
-
-    return false;
+    // The whole inheritance tree is flattened into one sorted array at export
+    return HashArraySearch(ancestor_hashes, type_name_hash) != -1;
 }
 
 const clcpp::Enum* clcpp::Type::AsEnum() const
@@ -501,21 +939,42 @@ clcpp::EnumConstant::EnumConstant()
 
 clcpp::Enum::Enum()
     : Type(KIND)
+    , value_table_min(0)
     , flag_attributes(0)
 {
 }
 
-const char* clcpp::Enum::GetValueName(int value) const
+const clcpp::EnumConstant* clcpp::Enum::FindConstantByValue(int value) const
 {
-    // Linear search for a matching constant value
-    for (unsigned int i = 0; i < constants.size; i++)
+    // Direct lookup into the value table when the exporter emitted one
+    if (value_table.size != 0)
+    {
+        unsigned int index = (unsigned int)value - (unsigned int)value_table_min;
+        return index < value_table.size ? value_table[index] : 0;
+    }
+
+    // Branchless lower bound over the value-sorted constants
+    if (sorted_constants.size == 0)
+        return 0;
+    const EnumConstant* const* base = sorted_constants.data;
+    unsigned int size = sorted_constants.size;
+    while (size > 1)
     {
-        const clcpp::EnumConstant* constant = constants[i];
-        if (constant->value == value)
-            return constant->name.text;
+        unsigned int half = size / 2;
+        base = base[half]->value <= value ? base + half : base;
+        size -= half;
     }
+    return (*base)->value == value ? *base : 0;
+}
 
-    return 0;
+const char* clcpp::Enum::GetValueName(int value) const
+{
+    // Deferred compact name text is rebuilt before it's returned
+    if (database != 0)
+        database->RequireSection(Database::SECTION_NAME_TEXT);
+
+    const EnumConstant* constant = FindConstantByValue(value);
+    return constant != 0 ? constant->name.text : 0;
 }
 
 clcpp::Field::Field()
@@ -574,6 +1033,12 @@ clcpp::Namespace::Namespace()
 clcpp::Database::Database()
     : m_DatabaseMem(0)
     , m_Allocator(0)
+    , m_FileHeader(0)
+    , m_RelocationData(0)
+    , m_BaseAddress(0)
+    , m_Options(0)
+    , m_LoadedSections(0)
+    , m_SectionLock(0)
 {
 }
 
@@ -588,38 +1053,91 @@ bool clcpp::Database::Load(IFile* file, IAllocator* allocator, unsigned int opti
     return Load(file, allocator, base_address, options);
 }
 
-bool clcpp::Database::Load(IFile* file, IAllocator* allocator, pointer_type base_address, unsigned int options)
+bool clcpp::Database::Load(IFile* file, IAllocator* allocator, pointer_type base_address, unsigned int options,
+                           IJobRunner* job_runner)
 {
     // Load the database
     internal::Assert(m_DatabaseMem == 0 && "Database already loaded");
+    internal::DatabaseFileHeader* file_header = 0;
+    m_DatabaseMem = ReadDatabase(file, allocator, file_header);
+    if (m_DatabaseMem == 0)
+        return false;
+
     m_Allocator = allocator;
-    m_DatabaseMem = LoadMemoryMappedDatabase(file, m_Allocator);
+    m_FileHeader = file_header;
+    m_RelocationData = (const char*)file_header + sizeof(*file_header);
+    LoadSections(base_address, options, job_runner);
 
-    if (m_DatabaseMem != 0)
+    // Release the relocation data if there are no sections left to load
+    if ((m_Options & OPT_LOAD_SECTIONS_ON_DEMAND) == 0)
     {
-        // Rebasing functions is required mainly for DLLs and executables that run under Windows 7
-        // using its Address Space Layout Randomisation security feature.
-        if ((options & OPT_DONT_REBASE_FUNCTIONS) == 0)
-            RebaseFunctions(*m_DatabaseMem, base_address);
+        m_Allocator->Free(file_header);
+        m_FileHeader = 0;
+        m_RelocationData = 0;
+    }
 
-        // Tell each loaded primitive that they belong to this database
-        ParentPrimitivesToDatabase(m_DatabaseMem->types, this);
-        ParentPrimitivesToDatabase(m_DatabaseMem->enum_constants, this);
-        ParentPrimitivesToDatabase(m_DatabaseMem->enums, this);
-        ParentPrimitivesToDatabase(m_DatabaseMem->fields, this);
-        ParentPrimitivesToDatabase(m_DatabaseMem->functions, this);
-        ParentPrimitivesToDatabase(m_DatabaseMem->classes, this);
-        ParentPrimitivesToDatabase(m_DatabaseMem->templates, this);
-        ParentPrimitivesToDatabase(m_DatabaseMem->template_types, this);
-        ParentPrimitivesToDatabase(m_DatabaseMem->namespaces, this);
-        ParentPrimitivesToDatabase(m_DatabaseMem->flag_attributes, this);
-        ParentPrimitivesToDatabase(m_DatabaseMem->int_attributes, this);
-        ParentPrimitivesToDatabase(m_DatabaseMem->float_attributes, this);
-        ParentPrimitivesToDatabase(m_DatabaseMem->primitive_attributes, this);
-        ParentPrimitivesToDatabase(m_DatabaseMem->text_attributes, this);
+    return true;
+}
+
+bool clcpp::Database::LoadMapped(void* data, size_type size, unsigned int options)
+{
+    clcpp::pointer_type base_address = GetLoadAddress();
+    return LoadMapped(data, size, base_address, options);
+}
+
+bool clcpp::Database::LoadMapped(void* data, size_type size, pointer_type base_address, unsigned int options,
+                                 IJobRunner* job_runner)
+{
+    // Use the caller's memory directly, leaving no allocator to free it with on unload
+    internal::Assert(m_DatabaseMem == 0 && "Database already loaded");
+    m_DatabaseMem = MapDatabase(data, size);
+    if (m_DatabaseMem == 0)
+        return false;
+
+    // The relocation data follows the memory map
+    m_Allocator = 0;
+    m_FileHeader = (const internal::DatabaseFileHeader*)data;
+    m_RelocationData = (const char*)m_DatabaseMem + m_FileHeader->data_size;
+    LoadSections(base_address, options, job_runner);
+
+    return true;
+}
+
+bool clcpp::Database::LoadStatic(const void* data)
+{
+    clcpp::pointer_type base_address = GetLoadAddress();
+    return LoadStatic(data, base_address);
+}
+
+bool clcpp::Database::LoadStatic(const void* data, pointer_type base_address)
+{
+    internal::Assert(m_DatabaseMem == 0 && "Database already loaded");
+    const internal::DatabaseFileHeader* file_header = (const internal::DatabaseFileHeader*)data;
+    if (file_header == 0 || !VerifyFileHeader(*file_header))
+        return false;
+
+    // The memory map follows the header, with all pointers already resolved by the linker
+    m_DatabaseMem = (internal::DatabaseMem*)(file_header + 1);
+    m_Allocator = 0;
+    m_FileHeader = 0;
+    m_RelocationData = 0;
+    m_BaseAddress = base_address;
+    m_Options = OPT_DONT_PARENT_PRIMITIVES;
+    m_LoadedSections = (1 << NB_SECTIONS) - 1;
+
+    // Functions are the only writable part of a static database, preceded by the base address their
+    // addresses are currently relative to. They only need rebasing on the first load in the process.
+    if (m_DatabaseMem->functions.size != 0)
+    {
+        pointer_type& function_base_address = ((pointer_type*)m_DatabaseMem->functions.data)[-1];
+        if (function_base_address != base_address)
+        {
+            RebaseFunctions(*m_DatabaseMem, function_base_address, base_address);
+            function_base_address = base_address;
+        }
     }
 
-    return m_DatabaseMem != 0;
+    return true;
 }
 
 bool clcpp::Database::UnLoad()
@@ -627,24 +1145,121 @@ bool clcpp::Database::UnLoad()
     bool isUnLoadSuccess= false;
     if (m_DatabaseMem != nullptr)
     {
-      m_Allocator->Free(m_DatabaseMem);
+      // Mapped databases are owned by the caller
+      if (m_Allocator != nullptr)
+      {
+        m_Allocator->Free(m_DatabaseMem);
+        if (m_FileHeader != nullptr)
+          m_Allocator->Free((void*)m_FileHeader);
+      }
       m_DatabaseMem = nullptr;
+      m_Allocator = nullptr;
+      m_FileHeader = nullptr;
+      m_RelocationData = nullptr;
+      m_LoadedSections = 0;
       isUnLoadSuccess = true;
     }
 
     return isUnLoadSuccess;
 }
 
+void clcpp::Database::LoadSection(Section section, IJobRunner* job_runner)
+{
+    internal::Assert(m_DatabaseMem != 0 && section < NB_SECTIONS);
+    if (IsSectionLoaded(section))
+        return;
+
+    // Only one thread can load at a time, with the others waiting for it to finish so that they
+    // never see a partially relocated section. Loads are rare so spinning is cheaper than an OS lock.
+    while (!AtomicCompareExchange(&m_SectionLock, 0, 1))
+    {
+        while (AtomicLoad(&m_SectionLock) != 0)
+            ;
+    }
+
+    if (!IsSectionLoaded(section))
+    {
+        // Relocation instructions are sorted by section
+        int first_relocation = 0;
+        for (int i = 0; i < section; i++)
+            first_relocation += m_FileHeader->nb_section_ptr_relocations[i];
+        RelocatePointers((char*)m_DatabaseMem, *m_FileHeader, m_RelocationData, first_relocation,
+                         m_FileHeader->nb_section_ptr_relocations[section], job_runner);
+
+        // Publish the section only once it's complete
+        InitialiseLoadedSection(this, *m_DatabaseMem, section, m_BaseAddress, m_Options);
+        AtomicStore(&m_LoadedSections, m_LoadedSections | (1 << section));
+    }
+
+    AtomicStore(&m_SectionLock, 0);
+}
+
+bool clcpp::Database::IsSectionLoaded(Section section) const
+{
+    return (AtomicLoad(&m_LoadedSections) & (1 << section)) != 0;
+}
+
+void clcpp::Database::LoadSections(pointer_type base_address, unsigned int options, IJobRunner* job_runner)
+{
+    // Sections can only be loaded on demand through primitives parented to the database
+    if (options & OPT_DONT_PARENT_PRIMITIVES)
+        options &= ~OPT_LOAD_SECTIONS_ON_DEMAND;
+
+    m_BaseAddress = base_address;
+    m_Options = options;
+    m_LoadedSections = 0;
+
+    LoadSection(SECTION_CORE, job_runner);
+    if ((options & OPT_LOAD_SECTIONS_ON_DEMAND) == 0)
+    {
+        for (int i = SECTION_CORE + 1; i < NB_SECTIONS; i++)
+            LoadSection((Section)i, job_runner);
+    }
+    else
+    {
+        // Compact name text reads as empty until it's rebuilt
+        char* text = (char*)m_DatabaseMem->name_text_data;
+        for (size_type i = 0; i < m_FileHeader->name_text_size; i++)
+            text[i] = 0;
+    }
+}
+
+void clcpp::Database::RequireSection(Section section) const
+{
+    // Sections are loaded on first use by the code that needs them
+    if (!IsSectionLoaded(section))
+        const_cast<Database*>(this)->LoadSection(section);
+}
+
 
 clcpp::Name clcpp::Database::GetName(unsigned int hash) const
 {
+    RequireSection(SECTION_NAMES);
+    RequireSection(SECTION_NAME_TEXT);
+
     // Lookup the name by hash
-    int index = BinarySearch<Name, Name, GetNameHash>(m_DatabaseMem->names, hash);
+    int index = HashSearch<Name, Name, GetNameHash>(m_DatabaseMem->name_index, m_DatabaseMem->names, hash);
     if (index == -1)
         return clcpp::Name();
     return m_DatabaseMem->names[index];
 }
 
+void clcpp::Database::GetNames(const unsigned int* hashes, unsigned int nb_hashes, Name* out_names) const
+{
+    RequireSection(SECTION_NAMES);
+    RequireSection(SECTION_NAME_TEXT);
+
+    int indices[HASH_SEARCH_BATCH_SIZE];
+    for (unsigned int i = 0; i < nb_hashes; i += HASH_SEARCH_BATCH_SIZE)
+    {
+        unsigned int nb_batch_hashes = nb_hashes - i < HASH_SEARCH_BATCH_SIZE ? nb_hashes - i : HASH_SEARCH_BATCH_SIZE;
+        HashSearchBatch<Name, Name, GetNameHash>(m_DatabaseMem->name_index, m_DatabaseMem->names, hashes + i,
+                                                 nb_batch_hashes, indices);
+        for (unsigned int j = 0; j < nb_batch_hashes; j++)
+            out_names[i + j] = indices[j] == -1 ? clcpp::Name() : m_DatabaseMem->names[indices[j]];
+    }
+}
+
 clcpp::Name clcpp::Database::GetName(const char* text) const
 {
     // Null pointer
@@ -659,14 +1274,64 @@ clcpp::Name clcpp::Database::GetName(const char* text) const
     return GetName(hash);
 }
 
+clcpp::size_type clcpp::Database::GetNameText(unsigned int hash, char* buffer, size_type buffer_size) const
+{
+    // Compact names can be rebuilt straight into the buffer, otherwise copy the stored text
+    int index = HashSearch<Name, Name, GetNameHash>(m_DatabaseMem->name_index, m_DatabaseMem->names, hash);
+    size_type length = 0;
+    if (index != -1 && m_DatabaseMem->compact_names.size != 0)
+    {
+        length = GetCompactNameLength(*m_DatabaseMem, index);
+        if (length < buffer_size)
+        {
+            WriteCompactName(*m_DatabaseMem, index, buffer, length);
+            return length;
+        }
+    }
+    else if (index != -1)
+    {
+        RequireSection(SECTION_NAMES);
+        const char* text = m_DatabaseMem->names[index].text;
+        length = strlen(text);
+        if (length < buffer_size)
+        {
+            memcpy(buffer, text, length + 1);
+            return length;
+        }
+    }
+
+    if (buffer_size != 0)
+        buffer[0] = 0;
+    return length;
+}
+
 const clcpp::Type* clcpp::Database::GetType(unsigned int hash) const
 {
-    return FindPrimitive(m_DatabaseMem->type_primitives, hash);
+    int index = HashSearch<const Type*, const Primitive*, GetPrimitivePtrHash>(
+        m_DatabaseMem->type_index, m_DatabaseMem->type_primitives, hash);
+    if (index == -1)
+        return 0;
+    return m_DatabaseMem->type_primitives[index];
+}
+
+void clcpp::Database::GetTypes(const unsigned int* hashes, unsigned int nb_hashes, const Type** out_types) const
+{
+    int indices[HASH_SEARCH_BATCH_SIZE];
+    for (unsigned int i = 0; i < nb_hashes; i += HASH_SEARCH_BATCH_SIZE)
+    {
+        unsigned int nb_batch_hashes = nb_hashes - i < HASH_SEARCH_BATCH_SIZE ? nb_hashes - i : HASH_SEARCH_BATCH_SIZE;
+        HashSearchBatch<const Type*, const Primitive*, GetPrimitivePtrHash>(
+            m_DatabaseMem->type_index, m_DatabaseMem->type_primitives, hashes + i,
+            nb_batch_hashes, indices);
+        for (unsigned int j = 0; j < nb_batch_hashes; j++)
+            out_types[i + j] = indices[j] == -1 ? 0 : m_DatabaseMem->type_primitives[indices[j]];
+    }
 }
 
 const clcpp::Namespace* clcpp::Database::GetNamespace(unsigned int hash) const
 {
-    int index = BinarySearch<Namespace, const Primitive&, GetPrimitiveHash>(m_DatabaseMem->namespaces, hash);
+    int index = HashSearch<Namespace, const Primitive&, GetPrimitiveHash>(
+        m_DatabaseMem->namespace_index, m_DatabaseMem->namespaces, hash);
     if (index == -1)
         return 0;
     return &m_DatabaseMem->namespaces[index];
@@ -679,7 +1344,8 @@ const clcpp::Namespace* clcpp::Database::GetGlobalNamespace() const
 
 const clcpp::Template* clcpp::Database::GetTemplate(unsigned int hash) const
 {
-    int index = BinarySearch<Template, const Primitive&, GetPrimitiveHash>(m_DatabaseMem->templates, hash);
+    int index = HashSearch<Template, const Primitive&, GetPrimitiveHash>(
+        m_DatabaseMem->template_index, m_DatabaseMem->templates, hash);
     if (index == -1)
         return 0;
     return &m_DatabaseMem->templates[index];
@@ -687,20 +1353,45 @@ const clcpp::Template* clcpp::Database::GetTemplate(unsigned int hash) const
 
 const clcpp::Function* clcpp::Database::GetFunction(unsigned int hash) const
 {
-    int index = BinarySearch<Function, const Primitive&, GetPrimitiveHash>(m_DatabaseMem->functions, hash);
+    RequireSection(SECTION_FUNCTIONS);
+
+    int index = HashSearch<Function, const Primitive&, GetPrimitiveHash>(
+        m_DatabaseMem->function_index, m_DatabaseMem->functions, hash);
     if (index == -1)
         return 0;
     return &m_DatabaseMem->functions[index];
 }
 
+void clcpp::Database::GetFunctions(const unsigned int* hashes, unsigned int nb_hashes,
+                                   const Function** out_functions) const
+{
+    RequireSection(SECTION_FUNCTIONS);
+
+    int indices[HASH_SEARCH_BATCH_SIZE];
+    for (unsigned int i = 0; i < nb_hashes; i += HASH_SEARCH_BATCH_SIZE)
+    {
+        unsigned int nb_batch_hashes = nb_hashes - i < HASH_SEARCH_BATCH_SIZE ? nb_hashes - i : HASH_SEARCH_BATCH_SIZE;
+        HashSearchBatch<Function, const Primitive&, GetPrimitiveHash>(
+            m_DatabaseMem->function_index, m_DatabaseMem->functions, hashes + i,
+            nb_batch_hashes, indices);
+        for (unsigned int j = 0; j < nb_batch_hashes; j++)
+            out_functions[i + j] = indices[j] == -1 ? 0 : &m_DatabaseMem->functions[indices[j]];
+    }
+}
+
 clcpp::Range clcpp::Database::GetOverloadedFunction(unsigned int hash) const
 {
+    RequireSection(SECTION_FUNCTIONS);
+
     // Quickly locate the first match
-    int index = BinarySearch<Function, const Primitive&, GetPrimitiveHash>(m_DatabaseMem->functions, hash);
+    int index = HashSearch<Function, const Primitive&, GetPrimitiveHash>(
+        m_DatabaseMem->function_index, m_DatabaseMem->functions, hash);
     if (index == -1)
         return Range();
 
     // Functions can be overloaded so look at the neighbours to widen the primitives found
+    if (m_DatabaseMem->function_hashes.size == m_DatabaseMem->functions.size)
+        return SearchHashNeighbours(m_DatabaseMem->function_hashes, hash, index);
     return SearchNeighbours<Function, const Primitive&, GetPrimitiveHash>(m_DatabaseMem->functions, hash, index);
 }
 
@@ -712,12 +1403,19 @@ const clcpp::Type** clcpp::Database::GetTypes(unsigned int& out_nb_types) const
 
 void clcpp::Database::SetTypes(const clcpp::Type** types, unsigned int nb_types)
 {
+    // Static databases have neither an allocator nor a file header and are in read-only memory
+    internal::Assert((m_Allocator != 0 || m_FileHeader != 0) && "Can't set the types of a static database");
+
     m_DatabaseMem->type_primitives.data = types;
     m_DatabaseMem->type_primitives.size = nb_types;
+
+    // The type index refers to the original array so fall back to a binary search of the new one
+    m_DatabaseMem->type_index.size = 0;
 }
 
 const clcpp::Function* clcpp::Database::GetFunctions(unsigned int& out_nb_functions) const
 {
+    RequireSection(SECTION_FUNCTIONS);
     out_nb_functions = m_DatabaseMem->functions.size;
     return m_DatabaseMem->functions.data;
 }
@@ -725,16 +1423,35 @@ const clcpp::Function* clcpp::Database::GetFunctions(unsigned int& out_nb_functi
 clcpp::internal::DatabaseMem::DatabaseMem()
     : function_base_address(0)
     , name_text_data(0)
+    , compact_name_suffix_data(0)
+{
+}
+
+clcpp::internal::CompactName::CompactName()
+    : parent(-1)
+    , suffix_offset(0)
+{
+}
+
+clcpp::internal::HashIndexSlot::HashIndexSlot()
+    : hash(0)
+    , index(0)
 {
 }
 
 clcpp::internal::DatabaseFileHeader::DatabaseFileHeader()
     : signature0('pclc')
     , signature1('\0bdp')
-    , version(2)
+    , version(15)
     , nb_ptr_schemas(0)
     , nb_ptr_offsets(0)
     , nb_ptr_relocations(0)
     , data_size(0)
+    , prelink_address(0)
+    , compression_block_size(0)
+    , name_text_offset(0)
+    , name_text_size(0)
 {
+    for (int i = 0; i < clcpp::Database::NB_SECTIONS; i++)
+        nb_section_ptr_relocations[i] = 0;
 }
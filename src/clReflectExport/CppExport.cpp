@@ -94,6 +94,63 @@ namespace
         }
     }
 
+    bool IsIdentifierChar(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    void BuildCompactNames(CppExport& cppexp)
+    {
+        std::map<std::string, int> name_indices;
+        for (unsigned int i = 0; i < cppexp.db->names.size; i++)
+            name_indices[cppexp.db->names[i].text] = i;
+
+        // Store each name as the longest name that prefixes it plus its remaining text. Only prefixes
+        // that end on an identifier boundary are considered, such as the scope of a fully-scoped name.
+        std::map<std::string, unsigned int> suffix_offsets;
+        std::vector<std::string> suffixes;
+        unsigned int suffix_data_size = 0;
+        cppexp.allocator.Alloc(cppexp.db->compact_names, cppexp.db->names.size);
+        for (unsigned int i = 0; i < cppexp.db->names.size; i++)
+        {
+            clcpp::internal::CompactName& compact_name = cppexp.db->compact_names[i];
+            std::string text = cppexp.db->names[i].text;
+            size_t prefix_length = 0;
+            compact_name.parent = -1;
+            for (size_t j = text.length(); j-- > 1;)
+            {
+                if (IsIdentifierChar(text[j]) && IsIdentifierChar(text[j - 1]))
+                    continue;
+                std::map<std::string, int>::const_iterator parent = name_indices.find(text.substr(0, j));
+                if (parent != name_indices.end())
+                {
+                    compact_name.parent = parent->second;
+                    prefix_length = j;
+                    break;
+                }
+            }
+
+            // Share the text of identical suffixes
+            std::string suffix = text.substr(prefix_length);
+            std::map<std::string, unsigned int>::const_iterator offset = suffix_offsets.find(suffix);
+            if (offset == suffix_offsets.end())
+            {
+                offset = suffix_offsets.insert(std::make_pair(suffix, suffix_data_size)).first;
+                suffixes.push_back(suffix);
+                suffix_data_size += suffix.length() + 1;
+            }
+            compact_name.suffix_offset = offset->second;
+        }
+
+        char* suffix_data = cppexp.allocator.Alloc<char>(suffix_data_size);
+        for (size_t i = 0; i < suffixes.size(); i++)
+        {
+            strcpy(suffix_data, suffixes[i].c_str());
+            suffix_data += suffixes[i].length() + 1;
+        }
+        cppexp.db->compact_name_suffix_data = suffix_data - suffix_data_size;
+    }
+
     // Overloads for copying primitives between databases
     void CopyPrimitive(clcpp::Primitive& dest, const cldb::Primitive& src, clcpp::Primitive::Kind kind)
     {
@@ -566,10 +623,225 @@ namespace
         }
     }
 
+    void GatherAncestorHashes(const clcpp::Type* type, std::vector<unsigned int>& hashes)
+    {
+        for (unsigned int i = 0; i < type->base_types.size; i++)
+        {
+            const clcpp::Type* base_type = type->base_types[i];
+            hashes.push_back(base_type->name.hash);
+            GatherAncestorHashes(base_type, hashes);
+        }
+    }
+
+    void BuildAncestorArrays(CppExport& cppexp)
+    {
+        // Flatten the inheritance tree of each type into a sorted list of unique hashes so that
+        // the runtime can answer DerivesFrom with a single binary search
+        std::vector<unsigned int> hashes;
+        for (unsigned int i = 0; i < cppexp.db->type_primitives.size; i++)
+        {
+            clcpp::Type* type = const_cast<clcpp::Type*>(cppexp.db->type_primitives[i]);
+            if (type->base_types.size == 0)
+                continue;
+
+            hashes.clear();
+            GatherAncestorHashes(type, hashes);
+            std::sort(hashes.begin(), hashes.end());
+            hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+            cppexp.allocator.Alloc(type->ancestor_hashes, hashes.size());
+            for (unsigned int j = 0; j < type->ancestor_hashes.size; j++)
+                type->ancestor_hashes[j] = hashes[j];
+        }
+    }
+
+    void GatherAllFields(const clcpp::Type* type, std::vector<const clcpp::Field*>& fields)
+    {
+        // Template types have no fields of their own but may still derive from classes
+        if (type->kind == clcpp::Primitive::KIND_CLASS)
+        {
+            const clcpp::Class* class_type = (const clcpp::Class*)type;
+            fields.insert(fields.end(), class_type->fields.data, class_type->fields.data + class_type->fields.size);
+        }
+
+        for (unsigned int i = 0; i < type->base_types.size; i++)
+            GatherAllFields(type->base_types[i], fields);
+    }
+
+    bool SortFieldByHash(const clcpp::Field* a, const clcpp::Field* b)
+    {
+        return a->name.hash < b->name.hash;
+    }
+
+    bool FieldHashesEqual(const clcpp::Field* a, const clcpp::Field* b)
+    {
+        return a->name.hash == b->name.hash;
+    }
+
+    void BuildAllFieldArrays(CppExport& cppexp)
+    {
+        // Flatten the fields of each class hierarchy into a single sorted array so that the runtime
+        // can find any field with one binary search, instead of searching each base class in turn
+        std::vector<const clcpp::Field*> fields;
+        for (unsigned int i = 0; i < cppexp.db->classes.size; i++)
+        {
+            clcpp::Class& cls = cppexp.db->classes[i];
+            if (cls.base_types.size == 0)
+            {
+                cls.all_fields = cls.fields;
+                continue;
+            }
+
+            // Fields are gathered derived class first so that a stable sort keeps any fields that
+            // hide those of the same name in a base class
+            fields.clear();
+            GatherAllFields(&cls, fields);
+            std::stable_sort(fields.begin(), fields.end(), SortFieldByHash);
+            fields.erase(std::unique(fields.begin(), fields.end(), FieldHashesEqual), fields.end());
+
+            cppexp.allocator.Alloc(cls.all_fields, fields.size());
+            for (unsigned int j = 0; j < cls.all_fields.size; j++)
+                cls.all_fields[j] = fields[j];
+        }
+    }
+
+    bool SortFieldByOffset(const clcpp::Field* a, const clcpp::Field* b)
+    {
+        return a->offset < b->offset;
+    }
+
+    void BuildOffsetSortedFieldArrays(CppExport& cppexp)
+    {
+        // Provide each class hierarchy's fields in declaration order so that serialisers can write them
+        // in that order without sorting at runtime
+        std::vector<const clcpp::Field*> fields;
+        for (unsigned int i = 0; i < cppexp.db->classes.size; i++)
+        {
+            clcpp::Class& cls = cppexp.db->classes[i];
+            fields.assign(cls.all_fields.data, cls.all_fields.data + cls.all_fields.size);
+            std::stable_sort(fields.begin(), fields.end(), SortFieldByOffset);
+
+            // Share memory when the name-sorted array is already in offset order
+            if (std::equal(fields.begin(), fields.end(), cls.all_fields.data))
+            {
+                cls.all_fields_by_offset = cls.all_fields;
+                continue;
+            }
+
+            cppexp.allocator.Alloc(cls.all_fields_by_offset, fields.size());
+            for (unsigned int j = 0; j < cls.all_fields_by_offset.size; j++)
+                cls.all_fields_by_offset[j] = fields[j];
+        }
+    }
+
+    unsigned int GetBaseFlagAttributes(const clcpp::Type* type, const clcpp::Type* parent_type)
+    {
+        // Combine the flags of every class on each path from the type down to the field's parent, which
+        // multiple inheritance can make more than one of
+        unsigned int flags = 0;
+        for (unsigned int i = 0; i < type->base_types.size; i++)
+        {
+            const clcpp::Type* base_type = type->base_types[i];
+            if (base_type != parent_type && !base_type->DerivesFrom(parent_type->name.hash))
+                continue;
+
+            if (base_type->kind == clcpp::Primitive::KIND_CLASS)
+                flags |= base_type->AsClass()->flag_attributes;
+            if (base_type != parent_type)
+                flags |= GetBaseFlagAttributes(base_type, parent_type);
+        }
+
+        return flags;
+    }
+
+    void BuildFieldBaseFlags(CppExport& cppexp, const clcpp::Class& cls, const clcpp::CArray<const clcpp::Field*>& fields,
+                             clcpp::CArray<unsigned int>& base_flags)
+    {
+        std::vector<unsigned int> flags(fields.size, 0);
+        bool any_flags = false;
+        for (unsigned int i = 0; i < fields.size; i++)
+        {
+            const clcpp::Primitive* parent = fields[i]->parent;
+            if (parent != 0 && parent != &cls && parent->kind == clcpp::Primitive::KIND_CLASS)
+                flags[i] = GetBaseFlagAttributes(&cls, (const clcpp::Type*)parent);
+            any_flags |= flags[i] != 0;
+        }
+
+        // Leave the array empty when there's nothing to skip
+        if (!any_flags)
+            return;
+
+        cppexp.allocator.Alloc(base_flags, fields.size);
+        for (unsigned int i = 0; i < base_flags.size; i++)
+            base_flags[i] = flags[i];
+    }
+
+    void BuildFieldBaseFlagArrays(CppExport& cppexp)
+    {
+        // Work out which fields are inherited through classes with flag attributes, such as transient base
+        // classes, so that serialisers don't have to search the class hierarchy for each field they save
+        for (unsigned int i = 0; i < cppexp.db->classes.size; i++)
+        {
+            clcpp::Class& cls = cppexp.db->classes[i];
+            if (cls.base_types.size == 0)
+                continue;
+
+            BuildFieldBaseFlags(cppexp, cls, cls.all_fields, cls.all_fields_base_flags);
+            if (cls.all_fields_by_offset.data == cls.all_fields.data)
+                cls.all_fields_by_offset_base_flags = cls.all_fields_base_flags;
+            else
+                BuildFieldBaseFlags(cppexp, cls, cls.all_fields_by_offset, cls.all_fields_by_offset_base_flags);
+        }
+    }
+
+    bool SortEnumConstantByValue(const clcpp::EnumConstant* a, const clcpp::EnumConstant* b)
+    {
+        return a->value < b->value;
+    }
+
+    bool EnumConstantValuesEqual(const clcpp::EnumConstant* a, const clcpp::EnumConstant* b)
+    {
+        return a->value == b->value;
+    }
+
+    void BuildEnumValueTables(CppExport& cppexp)
+    {
+        for (unsigned int i = 0; i < cppexp.db->enums.size; i++)
+        {
+            clcpp::Enum& e = cppexp.db->enums[i];
+            if (e.constants.size == 0)
+                continue;
+
+            // Stable sort the name-sorted constants by value so that, when several constants share a
+            // value, the one a linear search by name order would have found is kept
+            std::vector<const clcpp::EnumConstant*> sorted(e.constants.data, e.constants.data + e.constants.size);
+            std::stable_sort(sorted.begin(), sorted.end(), SortEnumConstantByValue);
+            sorted.erase(std::unique(sorted.begin(), sorted.end(), EnumConstantValuesEqual), sorted.end());
+
+            cppexp.allocator.Alloc(e.sorted_constants, sorted.size());
+            for (unsigned int j = 0; j < e.sorted_constants.size; j++)
+                e.sorted_constants[j] = sorted[j];
+
+            // Add a table indexed directly by value if the value range is compact enough that
+            // it's no more than twice the size of the sorted array
+            long long min_value = sorted.front()->value;
+            long long range = (long long)sorted.back()->value - min_value + 1;
+            if (range > (long long)sorted.size() * 2)
+                continue;
+
+            e.value_table_min = (int)min_value;
+            cppexp.allocator.Alloc(e.value_table, (clcpp::size_type)range);
+            for (unsigned int j = 0; j < e.value_table.size; j++)
+                e.value_table[j] = 0;
+            for (unsigned int j = 0; j < sorted.size(); j++)
+                e.value_table[sorted[j]->value - min_value] = sorted[j];
+        }
+    }
+
     int ReturnParameterIndex(const clcpp::CArray<const clcpp::Field*>& parameters)
     {
         // Linear search for the named return value
-        static unsigned int return_hash = clcpp::internal::HashNameString("return");
+        constexpr unsigned int return_hash = "return"_clhash;
         for (unsigned int i = 0; i < parameters.size; i++)
         {
             if (parameters[i]->name.hash == return_hash)
@@ -780,16 +1052,16 @@ namespace
 
     unsigned int GetFlagAttributeBits(const clcpp::CArray<const clcpp::Attribute*>& attributes)
     {
-        // Cache attribute names
-        static unsigned int disk_transient_hash = clcpp::internal::HashNameString("disk_transient");
-        static unsigned int network_transient_hash = clcpp::internal::HashNameString("network_transient");
-        static unsigned int replicate_transient_hash = clcpp::internal::HashNameString("replicate_transient");
-        static unsigned int export_transient_hash = clcpp::internal::HashNameString("export_transient");
-        static unsigned int transient_hash = clcpp::internal::HashNameString("transient");
-        static unsigned int pre_save_hash = clcpp::internal::HashNameString("pre_save");
-        static unsigned int post_load_hash = clcpp::internal::HashNameString("post_load");
-        static unsigned int custom_flag = clcpp::internal::HashNameString("custom_flag");
-        static unsigned int replicate_hash = clcpp::internal::HashNameString("replicate");
+        // Attribute name hashes
+        constexpr unsigned int disk_transient_hash = "disk_transient"_clhash;
+        constexpr unsigned int network_transient_hash = "network_transient"_clhash;
+        constexpr unsigned int replicate_transient_hash = "replicate_transient"_clhash;
+        constexpr unsigned int export_transient_hash = "export_transient"_clhash;
+        constexpr unsigned int transient_hash = "transient"_clhash;
+        constexpr unsigned int pre_save_hash = "pre_save"_clhash;
+        constexpr unsigned int post_load_hash = "post_load"_clhash;
+        constexpr unsigned int custom_flag = "custom_flag"_clhash;
+        constexpr unsigned int replicate_hash = "replicate"_clhash;
 
         // Merge all detected common flags
         unsigned int bits = 0;
@@ -842,8 +1114,8 @@ namespace
 
     unsigned int GetInheritedFlagAttributes(clcpp::Class& class_prim)
     {
-        static unsigned int custom_flag = clcpp::internal::HashNameString("custom_flag");
-        static unsigned int custom_flag_inherit = clcpp::internal::HashNameString("custom_flag_inherit");
+        constexpr unsigned int custom_flag = "custom_flag"_clhash;
+        constexpr unsigned int custom_flag_inherit = "custom_flag_inherit"_clhash;
 
         // Collect all custom attribute bits and set the mask determining inheritance
         unsigned int custom_flags = 0, custom_flags_mask = 0;
@@ -1031,6 +1303,102 @@ namespace
         VerifyPrimitives(cppexp, cppexp.db->text_attributes);
     }
 
+    unsigned int GetIndexHash(const clcpp::Name& name)
+    {
+        return name.hash;
+    }
+    unsigned int GetIndexHash(const clcpp::Primitive& primitive)
+    {
+        return primitive.name.hash;
+    }
+    unsigned int GetIndexHash(const clcpp::Primitive* primitive)
+    {
+        return primitive->name.hash;
+    }
+
+    // Uncompressed size of each block when exporting compressed data. Matches are only found
+    // within a block, so this is kept to the maximum match offset the block codec can encode.
+    const unsigned int COMPRESSION_BLOCK_SIZE = 64 * 1024;
+
+    void WriteCompressedData(FILE* fp, const char* data, size_t data_size)
+    {
+        std::vector<char> block_data(clcpp::internal::CompressBlockBound(COMPRESSION_BLOCK_SIZE));
+        for (size_t offset = 0; offset < data_size; offset += COMPRESSION_BLOCK_SIZE)
+        {
+            size_t block_size = std::min<size_t>(data_size - offset, COMPRESSION_BLOCK_SIZE);
+            unsigned int compressed_size = clcpp::internal::CompressBlock(data + offset, block_size, block_data.data());
+
+            // Store blocks raw if they don't compress
+            if (compressed_size >= block_size)
+            {
+                unsigned int stored_size = block_size | clcpp::internal::COMPRESSED_BLOCK_STORED;
+                fwrite(&stored_size, sizeof(stored_size), 1, fp);
+                fwrite(data + offset, block_size, 1, fp);
+            }
+            else
+            {
+                fwrite(&compressed_size, sizeof(compressed_size), 1, fp);
+                fwrite(block_data.data(), compressed_size, 1, fp);
+            }
+        }
+    }
+
+    bool IsFunctionParameter(const clcpp::Field& field)
+    {
+        return field.parent != 0 && field.parent->kind == clcpp::Primitive::KIND_FUNCTION;
+    }
+
+    template <typename TYPE>
+    void BuildHashIndex(CppExport& cppexp, clcpp::CArray<clcpp::internal::HashIndexSlot>& dest, const clcpp::CArray<TYPE>& src)
+    {
+        if (src.size == 0)
+            return;
+
+        // Use a power-of-two table that's at most half full to keep probe sequences short
+        unsigned int nb_slots = 1;
+        while (nb_slots < src.size * 2)
+            nb_slots <<= 1;
+        cppexp.allocator.Alloc(dest, nb_slots);
+
+        unsigned int mask = nb_slots - 1;
+        for (unsigned int i = 0; i < src.size; i++)
+        {
+            unsigned int hash = GetIndexHash(src[i]);
+            if (hash == 0)
+                continue;
+
+            // Overloaded primitives are adjacent in the sorted source array; only the first is
+            // indexed, leaving the runtime to search its neighbours for the rest
+            unsigned int j = hash & mask;
+            while (dest[j].hash != 0 && dest[j].hash != hash)
+                j = (j + 1) & mask;
+            if (dest[j].hash == 0)
+            {
+                dest[j].hash = hash;
+                dest[j].index = i;
+            }
+        }
+    }
+
+    template <typename TYPE>
+    void BuildHashArray(CppExport& cppexp, clcpp::CArray<unsigned int>& dest, const clcpp::CArray<TYPE>& src)
+    {
+        cppexp.allocator.Alloc(dest, src.size);
+        for (unsigned int i = 0; i < src.size; i++)
+            dest[i] = GetIndexHash(src[i]);
+    }
+
+    void BuildHashIndices(CppExport& cppexp)
+    {
+        BuildHashArray(cppexp, cppexp.db->function_hashes, cppexp.db->functions);
+
+        BuildHashIndex(cppexp, cppexp.db->name_index, cppexp.db->names);
+        BuildHashIndex(cppexp, cppexp.db->type_index, cppexp.db->type_primitives);
+        BuildHashIndex(cppexp, cppexp.db->namespace_index, cppexp.db->namespaces);
+        BuildHashIndex(cppexp, cppexp.db->template_index, cppexp.db->templates);
+        BuildHashIndex(cppexp, cppexp.db->function_index, cppexp.db->functions);
+    }
+
     void RemoveInvalidFields(clcpp::CArray<const clcpp::Field*>& fields)
     {
         // Remove invalid fields, leaving the memory allocated
@@ -1098,6 +1466,8 @@ bool BuildCppExport(const cldb::Database& db, CppExport& cppexp)
 
     // Build all the name data ready for the client to use and the exporter to debug with
     BuildNames(db, cppexp);
+    if (cppexp.compact_names)
+        BuildCompactNames(cppexp);
 
     // Generate a raw clcpp equivalent of the cldb database. At this point no primitives
     // will physically point to or contain each other, but they will reference each other
@@ -1191,6 +1561,10 @@ bool BuildCppExport(const cldb::Database& db, CppExport& cppexp)
 
     // Build base classes arrays after the type primitive array has been sorted
     BuildBaseClassArrays(cppexp, db);
+    BuildAncestorArrays(cppexp);
+
+    // Build value lookups after the enum constants have been sorted by name
+    BuildEnumValueTables(cppexp);
 
     // Each class may have constructor/destructor methods in their method list. Run through
     // each class and make pointers to these in the class. This is done after sorting so that
@@ -1223,13 +1597,19 @@ bool BuildCppExport(const cldb::Database& db, CppExport& cppexp)
     // if you compile is without warnings!
     IsolateInvalidPrimitives(cppexp);
 
+    // Flatten class hierarchy fields after any invalid fields have been removed
+    BuildAllFieldArrays(cppexp);
+    BuildOffsetSortedFieldArrays(cppexp);
+    BuildFieldBaseFlagArrays(cppexp);
+
+    // Build packed hash arrays and hash tables for fast runtime lookup of the sorted global primitive arrays
+    BuildHashIndices(cppexp);
+
     return true;
 }
 
-void SaveCppExport(CppExport& cppexp, const char* filename)
+static void AddPtrRelocations(CppExport& cppexp, PtrRelocator& relocator)
 {
-    PtrRelocator relocator(cppexp.allocator.GetData(), cppexp.allocator.GetAllocatedSize());
-
     // The position of the data member within a CArray is fixed, independent of type
     size_t array_ofs = array_data_offset();
 
@@ -1257,6 +1637,8 @@ void SaveCppExport(CppExport& cppexp, const char* filename)
         relocator.AddSchema<clcpp::internal::DatabaseMem>()
         (&clcpp::internal::DatabaseMem::name_text_data)
         (&clcpp::internal::DatabaseMem::names, array_ofs)
+        (&clcpp::internal::DatabaseMem::compact_names, array_ofs)
+        (&clcpp::internal::DatabaseMem::compact_name_suffix_data)
         (&clcpp::internal::DatabaseMem::types, array_ofs)
         (&clcpp::internal::DatabaseMem::enum_constants, array_ofs)
         (&clcpp::internal::DatabaseMem::enums, array_ofs)
@@ -1274,6 +1656,12 @@ void SaveCppExport(CppExport& cppexp, const char* filename)
         (&clcpp::internal::DatabaseMem::text_attributes, array_ofs)
         (&clcpp::internal::DatabaseMem::type_primitives, array_ofs)
         (&clcpp::internal::DatabaseMem::container_infos, array_ofs)
+        (&clcpp::internal::DatabaseMem::name_index, array_ofs)
+        (&clcpp::internal::DatabaseMem::type_index, array_ofs)
+        (&clcpp::internal::DatabaseMem::namespace_index, array_ofs)
+        (&clcpp::internal::DatabaseMem::template_index, array_ofs)
+        (&clcpp::internal::DatabaseMem::function_index, array_ofs)
+        (&clcpp::internal::DatabaseMem::function_hashes, array_ofs)
         (&clcpp::Namespace::namespaces, array_ofs + global_namespace_offset)
         (&clcpp::Namespace::types, array_ofs + global_namespace_offset)
         (&clcpp::Namespace::enums, array_ofs + global_namespace_offset)
@@ -1289,12 +1677,16 @@ void SaveCppExport(CppExport& cppexp, const char* filename)
 
     PtrSchema& schema_type = relocator.AddSchema<clcpp::Type>(&schema_primitive)
         (&clcpp::Type::base_types, array_ofs)
+        (&clcpp::Type::ancestor_hashes, array_ofs)
         (&clcpp::Type::ci);
 
     PtrSchema& schema_enum_constant = relocator.AddSchema<clcpp::EnumConstant>(&schema_primitive);
 
-    PtrSchema& schema_enum =
-        relocator.AddSchema<clcpp::Enum>(&schema_type)(&clcpp::Enum::constants, array_ofs)(&clcpp::Enum::attributes, array_ofs);
+    PtrSchema& schema_enum = relocator.AddSchema<clcpp::Enum>(&schema_type)
+        (&clcpp::Enum::constants, array_ofs)
+        (&clcpp::Enum::attributes, array_ofs)
+        (&clcpp::Enum::sorted_constants, array_ofs)
+        (&clcpp::Enum::value_table, array_ofs);
 
     PtrSchema& schema_field = relocator.AddSchema<clcpp::Field>(&schema_primitive)(&clcpp::Field::type)(
         &clcpp::Field::attributes, array_ofs)(&clcpp::Field::ci);
@@ -1310,7 +1702,11 @@ void SaveCppExport(CppExport& cppexp, const char* filename)
         (&clcpp::Class::methods, array_ofs)
         (&clcpp::Class::fields, array_ofs)
         (&clcpp::Class::attributes, array_ofs)
-        (&clcpp::Class::templates, array_ofs);
+        (&clcpp::Class::templates, array_ofs)
+        (&clcpp::Class::all_fields, array_ofs)
+        (&clcpp::Class::all_fields_by_offset, array_ofs)
+        (&clcpp::Class::all_fields_base_flags, array_ofs)
+        (&clcpp::Class::all_fields_by_offset_base_flags, array_ofs);
 
     PtrSchema& schema_template_type = relocator.AddSchema<clcpp::TemplateType>(&schema_type)
         (&clcpp::TemplateType::constructor)
@@ -1343,53 +1739,70 @@ void SaveCppExport(CppExport& cppexp, const char* filename)
     // clang-format on
 
     // Add pointers from the base database object
+    relocator.SetSection(clcpp::Database::SECTION_CORE);
     relocator.AddPointers(schema_database, cppexp.db);
-    relocator.AddPointers(schema_name, cppexp.db->names);
     relocator.AddPointers(schema_type, cppexp.db->types);
     relocator.AddPointers(schema_enum_constant, cppexp.db->enum_constants);
     relocator.AddPointers(schema_enum, cppexp.db->enums);
-    relocator.AddPointers(schema_field, cppexp.db->fields);
-    relocator.AddPointers(schema_function, cppexp.db->functions);
     relocator.AddPointers(schema_class, cppexp.db->classes);
     relocator.AddPointers(schema_template_type, cppexp.db->template_types);
     relocator.AddPointers(schema_template, cppexp.db->templates);
     relocator.AddPointers(schema_namespace, cppexp.db->namespaces);
+    relocator.AddPointers(schema_ptr, cppexp.db->type_primitives);
+    relocator.AddPointers(schema_container_info, cppexp.db->container_infos);
+
+    relocator.SetSection(clcpp::Database::SECTION_NAMES);
+    relocator.AddPointers(schema_name, cppexp.db->names);
+
+    relocator.SetSection(clcpp::Database::SECTION_FUNCTIONS);
+    relocator.AddPointers(schema_function, cppexp.db->functions);
+
+    relocator.SetSection(clcpp::Database::SECTION_ATTRIBUTES);
     relocator.AddPointers(schema_primitive, cppexp.db->flag_attributes);
     relocator.AddPointers(schema_int_attribute, cppexp.db->int_attributes);
     relocator.AddPointers(schema_float_attribute, cppexp.db->float_attributes);
     relocator.AddPointers(schema_primitive_attribute, cppexp.db->primitive_attributes);
     relocator.AddPointers(schema_text_attribute, cppexp.db->text_attributes);
-    relocator.AddPointers(schema_ptr, cppexp.db->type_primitives);
-    relocator.AddPointers(schema_container_info, cppexp.db->container_infos);
+
+    // Fields are shared between classes and function parameters so add them in runs of
+    // consecutive fields that belong to the same section
+    for (unsigned int i = 0; i < cppexp.db->fields.size;)
+    {
+        bool is_parameter = IsFunctionParameter(cppexp.db->fields[i]);
+        unsigned int j = i + 1;
+        while (j < cppexp.db->fields.size && IsFunctionParameter(cppexp.db->fields[j]) == is_parameter)
+            j++;
+
+        relocator.SetSection(is_parameter ? clcpp::Database::SECTION_FUNCTIONS : clcpp::Database::SECTION_CORE);
+        relocator.AddPointers(schema_field, &cppexp.db->fields[i], j - i);
+        i = j;
+    }
 
     // Add pointers for the array objects within each primitive
     // Note that currently these are expressed as general pointer relocation instructions
     // with a specific "pointer" schema. This is 12 bytes per AddPointers call (which gets
     // into the hundreds/thousands) that could be trimmed a little if a specific pointer
     // relocation instruction was introduced that would cost 8 bytes.
+    relocator.SetSection(clcpp::Database::SECTION_CORE);
     for (unsigned int i = 0; i < cppexp.db->enums.size; i++)
     {
         relocator.AddPointers(schema_ptr, cppexp.db->enums[i].constants);
-        relocator.AddPointers(schema_ptr, cppexp.db->enums[i].attributes);
-    }
-    for (unsigned int i = 0; i < cppexp.db->fields.size; i++)
-    {
-        relocator.AddPointers(schema_ptr, cppexp.db->fields[i].attributes);
-    }
-    for (unsigned int i = 0; i < cppexp.db->functions.size; i++)
-    {
-        relocator.AddPointers(schema_ptr, cppexp.db->functions[i].parameters);
-        relocator.AddPointers(schema_ptr, cppexp.db->functions[i].attributes);
+        relocator.AddPointers(schema_ptr, cppexp.db->enums[i].sorted_constants);
+        relocator.AddPointers(schema_ptr, cppexp.db->enums[i].value_table);
     }
     for (unsigned int i = 0; i < cppexp.db->classes.size; i++)
     {
         clcpp::Class& cls = cppexp.db->classes[i];
         relocator.AddPointers(schema_ptr, cls.enums);
         relocator.AddPointers(schema_ptr, cls.classes);
-        relocator.AddPointers(schema_ptr, cls.methods);
         relocator.AddPointers(schema_ptr, cls.fields);
-        relocator.AddPointers(schema_ptr, cls.attributes);
         relocator.AddPointers(schema_ptr, cls.templates);
+
+        // Field pointers shared with the fields array must only be relocated once
+        if (cls.all_fields.data != cls.fields.data)
+            relocator.AddPointers(schema_ptr, cls.all_fields);
+        if (cls.all_fields_by_offset.data != cls.all_fields.data)
+            relocator.AddPointers(schema_ptr, cls.all_fields_by_offset);
     }
     for (unsigned int i = 0; i < cppexp.db->templates.size; i++)
     {
@@ -1401,7 +1814,6 @@ void SaveCppExport(CppExport& cppexp, const char* filename)
         relocator.AddPointers(schema_ptr, cppexp.db->namespaces[i].types);
         relocator.AddPointers(schema_ptr, cppexp.db->namespaces[i].enums);
         relocator.AddPointers(schema_ptr, cppexp.db->namespaces[i].classes);
-        relocator.AddPointers(schema_ptr, cppexp.db->namespaces[i].functions);
         relocator.AddPointers(schema_ptr, cppexp.db->namespaces[i].templates);
     }
 
@@ -1409,7 +1821,6 @@ void SaveCppExport(CppExport& cppexp, const char* filename)
     relocator.AddPointers(schema_ptr, cppexp.db->global_namespace.types);
     relocator.AddPointers(schema_ptr, cppexp.db->global_namespace.enums);
     relocator.AddPointers(schema_ptr, cppexp.db->global_namespace.classes);
-    relocator.AddPointers(schema_ptr, cppexp.db->global_namespace.functions);
     relocator.AddPointers(schema_ptr, cppexp.db->global_namespace.templates);
 
     for (unsigned int i = 0; i < cppexp.db->type_primitives.size; i++)
@@ -1417,8 +1828,61 @@ void SaveCppExport(CppExport& cppexp, const char* filename)
         relocator.AddPointers(schema_ptr, cppexp.db->type_primitives[i]->base_types);
     }
 
-    // Make all pointers relative to the start address
-    relocator.MakeRelative();
+    relocator.SetSection(clcpp::Database::SECTION_FUNCTIONS);
+    for (unsigned int i = 0; i < cppexp.db->functions.size; i++)
+    {
+        relocator.AddPointers(schema_ptr, cppexp.db->functions[i].parameters);
+    }
+    for (unsigned int i = 0; i < cppexp.db->classes.size; i++)
+    {
+        relocator.AddPointers(schema_ptr, cppexp.db->classes[i].methods);
+    }
+    for (unsigned int i = 0; i < cppexp.db->namespaces.size; i++)
+    {
+        relocator.AddPointers(schema_ptr, cppexp.db->namespaces[i].functions);
+    }
+    relocator.AddPointers(schema_ptr, cppexp.db->global_namespace.functions);
+
+    relocator.SetSection(clcpp::Database::SECTION_ATTRIBUTES);
+    for (unsigned int i = 0; i < cppexp.db->enums.size; i++)
+    {
+        relocator.AddPointers(schema_ptr, cppexp.db->enums[i].attributes);
+    }
+    for (unsigned int i = 0; i < cppexp.db->fields.size; i++)
+    {
+        relocator.AddPointers(schema_ptr, cppexp.db->fields[i].attributes);
+    }
+    for (unsigned int i = 0; i < cppexp.db->functions.size; i++)
+    {
+        relocator.AddPointers(schema_ptr, cppexp.db->functions[i].attributes);
+    }
+    for (unsigned int i = 0; i < cppexp.db->classes.size; i++)
+    {
+        relocator.AddPointers(schema_ptr, cppexp.db->classes[i].attributes);
+    }
+}
+
+void SaveCppExport(CppExport& cppexp, const char* filename)
+{
+    PtrRelocator relocator(cppexp.allocator.GetData(), cppexp.allocator.GetAllocatedSize());
+    AddPtrRelocations(cppexp, relocator);
+
+    // Compact names leave the name text out of the file, to be rebuilt on load
+    clcpp::size_type name_text_offset = 0;
+    clcpp::size_type name_text_size = 0;
+    if (cppexp.compact_names)
+    {
+        name_text_offset = cppexp.db->name_text_data - (const char*)cppexp.allocator.GetData();
+        for (unsigned int i = 0; i < cppexp.db->names.size; i++)
+            name_text_size += strlen(cppexp.db->names[i].text) + 1;
+    }
+
+    // Make all pointers relative to the start address. When prelinking, the memory map follows
+    // the header in the file so offset the pointers to where it lands when the file is mapped.
+    clcpp::pointer_type prelink_address = 0;
+    if (cppexp.prelink_address != 0)
+        prelink_address = cppexp.prelink_address + sizeof(clcpp::internal::DatabaseFileHeader);
+    relocator.MakeRelative(prelink_address);
 
     // Open the output file
     FILE* fp = fopen(filename, "wb");
@@ -1439,13 +1903,27 @@ void SaveCppExport(CppExport& cppexp, const char* filename)
     clcpp::internal::DatabaseFileHeader header;
     header.nb_ptr_schemas = schemas.size();
     header.nb_ptr_offsets = nb_ptr_offsets;
-    const std::vector<PtrRelocation>& relocations = relocator.GetRelocations();
-    header.nb_ptr_relocations = relocations.size();
+    header.nb_ptr_relocations = 0;
+    for (int i = 0; i < clcpp::Database::NB_SECTIONS; i++)
+    {
+        header.nb_section_ptr_relocations[i] = relocator.GetRelocations(i).size();
+        header.nb_ptr_relocations += header.nb_section_ptr_relocations[i];
+    }
     header.data_size = cppexp.allocator.GetAllocatedSize();
+    header.prelink_address = prelink_address;
+    header.compression_block_size = cppexp.compress ? COMPRESSION_BLOCK_SIZE : 0;
+    header.name_text_offset = name_text_offset;
+    header.name_text_size = name_text_size;
     fwrite(&header, sizeof(header), 1, fp);
 
-    // Write the complete memory map
-    fwrite(cppexp.allocator.GetData(), cppexp.allocator.GetAllocatedSize(), 1, fp);
+    // Write the memory map, minus any name text
+    const char* data = (const char*)cppexp.allocator.GetData();
+    std::vector<char> stored_data(data, data + name_text_offset);
+    stored_data.insert(stored_data.end(), data + name_text_offset + name_text_size, data + header.data_size);
+    if (cppexp.compress)
+        WriteCompressedData(fp, stored_data.data(), stored_data.size());
+    else
+        fwrite(stored_data.data(), stored_data.size(), 1, fp);
 
     // Write the stride of each schema and the location of their pointers
     size_t ptrs_offset = 0;
@@ -1466,25 +1944,131 @@ void SaveCppExport(CppExport& cppexp, const char* filename)
         fwrite(&s.ptr_offsets.front(), sizeof(size_t), s.ptr_offsets.size(), fp);
     }
 
-    // Write the relocations
-    fwrite(&relocations.front(), sizeof(PtrRelocation), relocations.size(), fp);
+    // Write the relocations, grouped by section
+    for (int i = 0; i < clcpp::Database::NB_SECTIONS; i++)
+    {
+        const std::vector<PtrRelocation>& relocations = relocator.GetRelocations(i);
+        if (!relocations.empty())
+            fwrite(&relocations.front(), sizeof(PtrRelocation), relocations.size(), fp);
+    }
 	
 	fflush(fp);
 
     fclose(fp);
 }
 
-namespace
+static void WriteCppSourceWords(FILE* fp, const std::vector<clcpp::pointer_type>& words, const std::vector<bool>& is_ptr,
+                                size_t begin, size_t end, const char* cast, const char* symbol,
+                                const char* functions_symbol, size_t functions_begin, size_t functions_end)
 {
-    bool SortFieldByOffset(const clcpp::Field* a, const clcpp::Field* b)
+    size_t word_size = sizeof(clcpp::pointer_type);
+    size_t nb_function_bytes = functions_end - functions_begin;
+    for (size_t i = begin; i < end; i++)
     {
-        return a->offset < b->offset;
+        fprintf(fp, (i - begin) % 8 == 0 ? "\n    " : " ");
+        if (is_ptr[i])
+        {
+            // Point into whichever array now holds the target, accounting for the functions moved out
+            // of the main array
+            size_t target = words[i];
+            if (target >= functions_begin && target < functions_end)
+            {
+                target = target - functions_begin + word_size;
+                fprintf(fp, "%s((char*)%s + %llu),", cast, functions_symbol, (unsigned long long)target);
+            }
+            else
+            {
+                if (target >= functions_end)
+                    target -= nb_function_bytes;
+                fprintf(fp, "%s((const char*)%s + %llu),", cast, symbol, (unsigned long long)target);
+            }
+        }
+        else if (words[i] != 0)
+            fprintf(fp, "%s0x%llx,", cast, (unsigned long long)words[i]);
+        else
+            fprintf(fp, "0,");
     }
-    bool SortEnumConstantByValue(const clcpp::EnumConstant* a, const clcpp::EnumConstant* b)
+}
+
+void SaveCppExportSource(CppExport& cppexp, const char* filename, const char* symbol)
+{
+    PtrRelocator relocator(cppexp.allocator.GetData(), cppexp.allocator.GetAllocatedSize());
+    AddPtrRelocations(cppexp, relocator);
+
+    // Copy the header and memory map into an array of pointer-sized words. As the memory map follows
+    // the header, its pointers are relative to the start of the array.
+    size_t data_size = cppexp.allocator.GetAllocatedSize();
+    size_t header_size = sizeof(clcpp::internal::DatabaseFileHeader);
+    size_t word_size = sizeof(clcpp::pointer_type);
+    size_t nb_words = (header_size + data_size + word_size - 1) / word_size;
+    std::vector<clcpp::pointer_type> words(nb_words, 0);
+    clcpp::internal::DatabaseFileHeader* header = new (words.data()) clcpp::internal::DatabaseFileHeader;
+    header->data_size = data_size;
+    memcpy((char*)words.data() + header_size, cppexp.allocator.GetData(), data_size);
+
+    // Mark which words are non-null pointers that need to be written as an address in the array
+    std::vector<size_t> ptr_offsets;
+    relocator.GetPointerOffsets(ptr_offsets);
+    std::vector<bool> is_ptr(nb_words, false);
+    const char* data = (const char*)cppexp.allocator.GetData();
+    for (size_t i = 0; i < ptr_offsets.size(); i++)
+    {
+        size_t offset = header_size + ptr_offsets[i];
+        assert(offset % word_size == 0 && "Unaligned pointer in memory map");
+        size_t index = offset / word_size;
+        if (words[index] != 0)
+        {
+            words[index] = words[index] - (clcpp::pointer_type)data + header_size;
+            is_ptr[index] = true;
+        }
+    }
+
+    // Function addresses are rebased when the database is loaded, so the functions are moved out to
+    // their own writable array that starts with the base address they're relative to
+    const clcpp::CArray<clcpp::Function>& functions = cppexp.db->functions;
+    size_t functions_begin = 0, functions_end = 0;
+    if (functions.size != 0)
     {
-        return a->value < b->value;
+        functions_begin = header_size + ((const char*)functions.data - data);
+        functions_end = functions_begin + functions.size * sizeof(clcpp::Function);
+        assert(functions_begin % word_size == 0 && functions_end % word_size == 0 && "Unaligned function array");
+    }
+    std::string functions_symbol = std::string(symbol) + "Functions";
+
+    FILE* fp = fopen(filename, "w");
+    if (fp == 0)
+    {
+        return;
+    }
+
+    // The arrays are declared extern so that they have external linkage. They're arrays of pointers,
+    // rather than integers, so that each pointer is written as an address constant: casting an address
+    // to an integer would make MSVC initialise the array with code at startup.
+    fprintf(fp, "//\n// Reflection database generated by clexport, loaded with clcpp::Database::LoadStatic\n//\n\n");
+    fprintf(fp, "extern const void* const %s[];\n", symbol);
+    if (functions.size != 0)
+    {
+        fprintf(fp, "extern void* %s[];\n\n", functions_symbol.c_str());
+        fprintf(fp, "void* %s[%d] = {\n    (void*)0x%llx,", functions_symbol.c_str(),
+                (int)((functions_end - functions_begin) / word_size + 1),
+                (unsigned long long)cppexp.db->function_base_address);
+        WriteCppSourceWords(fp, words, is_ptr, functions_begin / word_size, functions_end / word_size, "(void*)", symbol,
+                            functions_symbol.c_str(), functions_begin, functions_end);
+        fprintf(fp, "\n};\n");
     }
 
+    fprintf(fp, "\nconst void* const %s[%d] = {", symbol, (int)(nb_words - (functions_end - functions_begin) / word_size));
+    WriteCppSourceWords(fp, words, is_ptr, 0, functions_begin / word_size, "(const void*)", symbol,
+                        functions_symbol.c_str(), functions_begin, functions_end);
+    WriteCppSourceWords(fp, words, is_ptr, functions_end / word_size, nb_words, "(const void*)", symbol,
+                        functions_symbol.c_str(), functions_begin, functions_end);
+    fprintf(fp, "\n};\n");
+
+    fclose(fp);
+}
+
+namespace
+{
     // forward declarations
     void LogPrimitive(const clcpp::Field& field);
     void LogPrimitive(const clcpp::Function& func);
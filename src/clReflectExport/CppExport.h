@@ -25,6 +25,9 @@ struct CppExport
     CppExport(clcpp::pointer_type function_base_address)
         : allocator(5 * 1024 * 1024) // 5MB should do for now
         , function_base_address(function_base_address)
+        , prelink_address(0)
+        , compress(false)
+        , compact_names(false)
         , db(0)
     {
     }
@@ -32,6 +35,18 @@ struct CppExport
     StackAllocator allocator;
 
     clcpp::pointer_type function_base_address;
+
+    // Address the exported file is expected to be memory-mapped at, allowing it to be loaded
+    // without pointer relocation. Zero for no prelinking.
+    clcpp::pointer_type prelink_address;
+
+    // Compress the memory-mapped data when saving. Compressed files can't be loaded in-place.
+    bool compress;
+
+    // Store names as a prefix name plus suffix, leaving the full name text to be rebuilt on load.
+    // Must be set before BuildCppExport. Files with compact names can't be loaded in-place.
+    bool compact_names;
+
     clcpp::internal::DatabaseMem* db;
 
     // Hash of names for easier debugging
@@ -41,4 +56,7 @@ struct CppExport
 
 bool BuildCppExport(const cldb::Database& db, CppExport& cppexp);
 void SaveCppExport(CppExport& cppexport, const char* filename);
+
+// Save as C++ source defining the database as a statically initialised array with the given name
+void SaveCppExportSource(CppExport& cppexport, const char* filename, const char* symbol);
 void WriteCppExportAsText(const CppExport& cppexp, const char* filename);
@@ -17,6 +17,8 @@
 #include <clReflectCore/DatabaseTextSerialiser.h>
 #include <clReflectCore/Logging.h>
 
+#include <stdlib.h>
+
 int main(int argc, const char* argv[])
 {
     LOG_TO_STDOUT(main, ALL);
@@ -53,21 +55,40 @@ int main(int argc, const char* argv[])
     }
 
     std::string cpp_export = args.GetProperty("-cpp");
-    if (cpp_export != "")
+    std::string cpp_src = args.GetProperty("-cpp_src");
+    if (cpp_export != "" || cpp_src != "")
     {
         // First build the C++ export representation
         CppExport cppexp(function_base_address);
+        cppexp.compact_names = args.Have("-cpp_compact_names");
         if (!BuildCppExport(db, cppexp))
             return 1;
 
+        // Optional address that the output file will be mapped at by the runtime
+        std::string cpp_prelink = args.GetProperty("-cpp_prelink");
+        if (cpp_prelink != "")
+            cppexp.prelink_address = (clcpp::pointer_type)strtoull(cpp_prelink.c_str(), 0, 16);
+
+        // Optionally trade load time for a smaller output file
+        cppexp.compress = args.Have("-cpp_compress");
+
         // Pretty-print the result to the specified output file
         std::string cpp_log = args.GetProperty("-cpp_log");
         if (cpp_log != "")
             WriteCppExportAsText(cppexp, cpp_log.c_str());
 
+        // Optionally save as C++ source for linking into the executable. This leaves the
+        // CppExport object untouched.
+        if (cpp_src != "")
+        {
+            std::string cpp_src_symbol = args.GetProperty("-cpp_src_symbol");
+            SaveCppExportSource(cppexp, cpp_src.c_str(), cpp_src_symbol != "" ? cpp_src_symbol.c_str() : "clcppStaticDatabase");
+        }
+
         // Save to disk
         // NOTE: After this point the CppExport object is useless (TODO: fix)
-        SaveCppExport(cppexp, cpp_export.c_str());
+        if (cpp_export != "")
+            SaveCppExport(cppexp, cpp_export.c_str());
     }
 
     return 0;
@@ -23,6 +23,8 @@ namespace
 PtrRelocator::PtrRelocator(const void* start, size_t data_size)
     : m_Start((char*)start)
     , m_DataSize(data_size)
+    , m_Section(0)
+    , m_Relocations(1)
 {
 }
 
@@ -45,6 +47,13 @@ PtrSchema& PtrRelocator::AddSchema(size_t stride, PtrSchema* base_schema)
     return schema;
 }
 
+void PtrRelocator::SetSection(int section)
+{
+    m_Section = section;
+    if (m_Relocations.size() <= (size_t)section)
+        m_Relocations.resize(section + 1);
+}
+
 void PtrRelocator::AddPointers(const PtrSchema& schema, const void* data, int nb_objects)
 {
     // No need to add null pointers for patching
@@ -55,36 +64,57 @@ void PtrRelocator::AddPointers(const PtrSchema& schema, const void* data, int nb
     relocation.schema_handle = schema.handle;
     relocation.offset = distance(m_Start, data);
     relocation.nb_objects = nb_objects;
-    m_Relocations.push_back(relocation);
+    m_Relocations[m_Section].push_back(relocation);
 }
 
-void PtrRelocator::MakeRelative()
+void PtrRelocator::MakeRelative(size_t prelink_address)
 {
-    // Process each relocation instruction
+    // Process each relocation instruction in every section
     for (size_t i = 0; i < m_Relocations.size(); i++)
     {
-        PtrRelocation& reloc = m_Relocations[i];
-        PtrSchema& schema = *m_SchemaLookup[reloc.schema_handle];
-
-        // Iterate over every object
-        for (int j = 0; j < reloc.nb_objects; j++)
+        for (size_t r = 0; r < m_Relocations[i].size(); r++)
         {
-            size_t object_offset = reloc.offset + j * schema.stride;
+            PtrRelocation& reloc = m_Relocations[i][r];
+            PtrSchema& schema = *m_SchemaLookup[reloc.schema_handle];
 
-            // Get a reference to each pointer in the current object
-            for (size_t k = 0; k < schema.ptr_offsets.size(); k++)
+            // Iterate over every object
+            for (int j = 0; j < reloc.nb_objects; j++)
             {
-                unsigned int ptr_offset = object_offset + schema.ptr_offsets[k];
-                char*& ptr = (char*&)*(m_Start + ptr_offset);
+                size_t object_offset = reloc.offset + j * schema.stride;
 
-                // Only relocate if it's non-null
-                if (ptr != 0)
+                // Get a reference to each pointer in the current object
+                for (size_t k = 0; k < schema.ptr_offsets.size(); k++)
                 {
-                    size_t d = distance(m_Start, ptr);
-                    assert(d <= m_DataSize);
-                    ptr = (char*)d;
+                    unsigned int ptr_offset = object_offset + schema.ptr_offsets[k];
+                    char*& ptr = (char*&)*(m_Start + ptr_offset);
+
+                    // Only relocate if it's non-null
+                    if (ptr != 0)
+                    {
+                        size_t d = distance(m_Start, ptr);
+                        assert(d <= m_DataSize);
+                        ptr = (char*)(d + prelink_address);
+                    }
                 }
             }
         }
     }
-}
\ No newline at end of file
+}
+
+void PtrRelocator::GetPointerOffsets(std::vector<size_t>& offsets) const
+{
+    for (size_t i = 0; i < m_Relocations.size(); i++)
+    {
+        for (size_t r = 0; r < m_Relocations[i].size(); r++)
+        {
+            const PtrRelocation& reloc = m_Relocations[i][r];
+            const PtrSchema& schema = *m_SchemaLookup[reloc.schema_handle];
+            for (int j = 0; j < reloc.nb_objects; j++)
+            {
+                size_t object_offset = reloc.offset + j * schema.stride;
+                for (size_t k = 0; k < schema.ptr_offsets.size(); k++)
+                    offsets.push_back(object_offset + schema.ptr_offsets[k]);
+            }
+        }
+    }
+}
@@ -84,6 +84,10 @@ public:
     // Add a new schema which doesn't have any pointer offsets beyond those it inherits
     PtrSchema& AddSchema(size_t stride, PtrSchema* base_schema);
 
+    // Set the section that subsequently added pointers belong to. Relocation instructions are
+    // grouped by section so that each section can be relocated independently.
+    void SetSection(int section);
+
     // Add pointers for any number of objects given the schema handle
     void AddPointers(const PtrSchema& schema, const void* data, int nb_objects = 1);
 
@@ -102,16 +106,24 @@ public:
         AddPointers(schema, array.data, array.size);
     }
 
-    // Make all pointers relative to the start memory address
-    void MakeRelative();
+    // Make all pointers relative to the start memory address, with an optional address to
+    // add to all non-null pointers so that they are pre-linked at that address
+    void MakeRelative(size_t prelink_address = 0);
+
+    // Get the offset of every pointer added for relocation, in the order they were added
+    void GetPointerOffsets(std::vector<size_t>& offsets) const;
 
     const std::vector<PtrSchema*>& GetSchemas() const
     {
         return m_SchemaLookup;
     }
-    const std::vector<PtrRelocation>& GetRelocations() const
+    int GetNbSections() const
+    {
+        return (int)m_Relocations.size();
+    }
+    const std::vector<PtrRelocation>& GetRelocations(int section) const
     {
-        return m_Relocations;
+        return m_Relocations[section];
     }
 
 private:
@@ -123,5 +135,7 @@ private:
     std::list<PtrSchema> m_Schemas;
     std::vector<PtrSchema*> m_SchemaLookup;
 
-    std::vector<PtrRelocation> m_Relocations;
+    // Relocation instructions for each section
+    int m_Section;
+    std::vector<std::vector<PtrRelocation> > m_Relocations;
 };
@@ -100,7 +100,7 @@ class StackAllocator
 {
 public:
     StackAllocator(int size)
-        : m_Data(new char[size])
+        : m_Data(new char[size]())
         , m_Size(size)
         , m_Offset(0)
     {
@@ -109,7 +109,9 @@ public:
     template <typename TYPE>
     TYPE* Alloc(unsigned int count)
     {
-        // Allocate the required amount of bytes
+        // Allocate the required amount of bytes, naturally aligned so that the memory map can be
+        // used in-place and emitted as an array of pointer-sized words
+        m_Offset = (m_Offset + alignof(TYPE) - 1) & ~(unsigned int)(alignof(TYPE) - 1);
         TYPE* data = (TYPE*)(m_Data + m_Offset);
         m_Offset += count * sizeof(TYPE);
         assert(m_Offset <= m_Size && "Stack allocator overflowed");
@@ -8,66 +8,13 @@
 // ===============================================================================
 //
 
-#include <clcpp/clcpp.h>
+#include "TestFile.h"
 
 #include <cstdio>
-#if defined(CLCPP_USING_MSVC)
-#include <malloc.h>
-#else
-#include <stdlib.h>
-#endif
 #include <stdarg.h>
 #include <errno.h>
 
 
-class StdFile : public clcpp::IFile
-{
-public:
-	StdFile(const char* filename)
-	{
-		m_FP = fopen(filename, "rb");
-		if (m_FP == 0)
-		{
-			return;
-		}
-	}
-
-	~StdFile()
-	{
-		if (m_FP != 0)
-		{
-			fclose(m_FP);
-		}
-	}
-
-	bool IsOpen() const
-	{
-		return m_FP != 0;
-	}
-
-	bool Read(void* dest, clcpp::size_type size)
-	{
-		return fread(dest, 1, size, m_FP) == size;
-	}
-
-private:
-	FILE* m_FP;
-};
-
-
-class Malloc : public clcpp::IAllocator
-{
-	void* Alloc(clcpp::size_type size)
-	{
-		return malloc(size);
-	}
-	void Free(void* ptr)
-	{
-		free(ptr);
-	}
-};
-
-
 extern void TestGetType(clcpp::Database& db);
 extern void TestArraysFunc(clcpp::Database& db);
 extern void TestConstructorDestructor(clcpp::Database& db);
@@ -77,6 +24,11 @@ extern void TestSerialiseJSON(clcpp::Database& db);
 extern void TestOffsets(clcpp::Database& db);
 extern void TestTypedefsFunc(clcpp::Database& db);
 extern void TestFunctionSerialise(clcpp::Database& db);
+extern void TestStaticDatabase(clcpp::Database& db);
+extern void TestCompressedDatabase(clcpp::Database& db);
+extern void TestDatabase(clcpp::Database& db);
+extern void TestDatabaseHandle(clcpp::Database& db);
+extern void TestModuleRegistry(clcpp::Database& db);
 
 extern void clcppInitGetType(const clcpp::Database* db);
 
@@ -105,6 +57,11 @@ int main()
 	TestSerialiseJSON(db);
 	TestTypedefsFunc(db);
 	TestFunctionSerialise(db);
+	TestStaticDatabase(db);
+	TestCompressedDatabase(db);
+	TestDatabase(db);
+	TestDatabaseHandle(db);
+	TestModuleRegistry(db);
 
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,111 @@
+//
+// ===============================================================================
+// clReflect
+// -------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 Don Williamson & clReflect Authors (see AUTHORS file)
+// Released under MIT License (see LICENSE file)
+// ===============================================================================
+//
+
+#include <clcpp/clcpp.h>
+
+#include <stdio.h>
+
+
+namespace
+{
+	bool IsTypeHash(const clcpp::Type** types, unsigned int nb_types, unsigned int hash)
+	{
+		for (unsigned int i = 0; i < nb_types; i++)
+		{
+			if (types[i]->name.hash == hash)
+				return true;
+		}
+		return false;
+	}
+
+
+	bool TestLookup(clcpp::Database& db)
+	{
+		// Every type is found by its own hash, one at a time and batched
+		unsigned int nb_types = 0;
+		const clcpp::Type** types = db.GetTypes(nb_types);
+		const unsigned int BATCH_SIZE = 40;
+		unsigned int hashes[BATCH_SIZE];
+		const clcpp::Type* found[BATCH_SIZE];
+		for (unsigned int i = 0; i < nb_types; i += BATCH_SIZE)
+		{
+			unsigned int nb_hashes = nb_types - i < BATCH_SIZE ? nb_types - i : BATCH_SIZE;
+			for (unsigned int j = 0; j < nb_hashes; j++)
+			{
+				if (db.GetType(types[i + j]->name.hash) != types[i + j])
+					return false;
+				hashes[j] = types[i + j]->name.hash;
+			}
+
+			db.GetTypes(hashes, nb_hashes, found);
+			for (unsigned int j = 0; j < nb_hashes; j++)
+			{
+				if (found[j] != types[i + j])
+					return false;
+			}
+		}
+
+		// Functions may be overloaded, so only their hashes need to match
+		unsigned int nb_functions = 0;
+		const clcpp::Function* functions = db.GetFunctions(nb_functions);
+		for (unsigned int i = 0; i < nb_functions; i++)
+		{
+			unsigned int hash = functions[i].name.hash;
+			const clcpp::Function* function = db.GetFunction(hash);
+			if (function == 0 || function->name.hash != hash)
+				return false;
+			clcpp::Range range = db.GetOverloadedFunction(hash);
+			if (i < range.first || i >= range.last)
+				return false;
+		}
+
+		// Namespaces are found from the global namespace
+		const clcpp::Namespace* global = db.GetGlobalNamespace();
+		for (unsigned int i = 0; i < global->namespaces.size; i++)
+		{
+			if (db.GetNamespace(global->namespaces[i]->name.hash) != global->namespaces[i])
+				return false;
+		}
+
+		// Names that were never reflected aren't found
+		unsigned int missing = clcpp::internal::HashNameString("TestDatabase::NotReflected");
+		while (IsTypeHash(types, nb_types, missing))
+			missing++;
+		if (db.GetType(missing) != 0)
+			return false;
+
+		// Empty slots in the hash index have a hash of zero, which must not match them
+		if (db.GetType(0) != 0 || db.GetNamespace(0) != 0 || db.GetTemplate(0) != 0 || db.GetFunction(0) != 0)
+			return false;
+		clcpp::Range range = db.GetOverloadedFunction(0);
+		if (range.first != range.last)
+			return false;
+
+		unsigned int miss_hashes[] = { 0, missing, 0 };
+		const clcpp::Type* miss_types[] = { types[0], types[0], types[0] };
+		const clcpp::Function* miss_functions[] = { functions, functions, functions };
+		db.GetTypes(miss_hashes, 3, miss_types);
+		db.GetFunctions(miss_hashes, 3, miss_functions);
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			if (miss_types[i] != 0 || miss_functions[i] != 0)
+				return false;
+		}
+
+		return true;
+	}
+}
+
+
+void TestDatabase(clcpp::Database& db)
+{
+	printf("---------------------\n");
+	printf("NAME: Lookup\n");
+	printf(TestLookup(db) ? "PASS\n" : "FAIL\n");
+}
@@ -0,0 +1,135 @@
+//
+// ===============================================================================
+// clReflect
+// -------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 Don Williamson & clReflect Authors (see AUTHORS file)
+// Released under MIT License (see LICENSE file)
+// ===============================================================================
+//
+
+#include <clcpp/DatabaseHandle.h>
+
+#include <stdio.h>
+
+
+namespace
+{
+	bool TestReaderSlots()
+	{
+		clcpp::DatabaseHandle handle;
+		unsigned int reader0 = handle.AddReader();
+		unsigned int reader1 = handle.AddReader();
+		if (reader0 == reader1)
+			return false;
+
+		// Released slots are handed to the next reader, whether or not they ever read
+		handle.RemoveReader(reader0);
+		if (handle.AddReader() != reader0)
+			return false;
+		handle.BeginRead(reader1);
+		handle.EndRead(reader1);
+		handle.RemoveReader(reader1);
+		if (handle.AddReader() != reader1)
+			return false;
+
+		// Every slot can be used at once
+		for (unsigned int i = 2; i < clcpp::DatabaseHandle::MAX_READERS; i++)
+		{
+			if (handle.AddReader() != i)
+				return false;
+		}
+		handle.RemoveReader(clcpp::DatabaseHandle::MAX_READERS - 1);
+		return handle.AddReader() == clcpp::DatabaseHandle::MAX_READERS - 1;
+	}
+
+
+	bool TestSwap()
+	{
+		// The handle only passes databases around so they don't need loading
+		clcpp::Database old_db, new_db;
+		clcpp::DatabaseHandle handle;
+		unsigned int reader = handle.AddReader();
+		unsigned int late_reader = handle.AddReader();
+		if (!handle.Swap(&old_db) || handle.Reclaim() != 0)
+			return false;
+
+		// The old database can't be reclaimed while a reader that began before the swap is using it
+		if (handle.BeginRead(reader) != &old_db)
+			return false;
+		if (!handle.Swap(&new_db) || handle.Reclaim() != 0)
+			return false;
+
+		// Readers that begin after the swap get the new database and don't hold up the old one
+		if (handle.BeginRead(late_reader) != &new_db || handle.Reclaim() != 0)
+			return false;
+		handle.EndRead(reader);
+		if (handle.Reclaim() != &old_db || handle.Reclaim() != 0)
+			return false;
+		handle.EndRead(late_reader);
+
+		// Swapping in null releases the last database on shutdown
+		if (!handle.Swap(0) || handle.Reclaim() != &new_db || handle.Reclaim() != 0)
+			return false;
+		return handle.BeginRead(reader) == 0;
+	}
+
+
+	bool TestRetiredLimit()
+	{
+		const unsigned int NB_DATABASES = clcpp::DatabaseHandle::MAX_RETIRED + 2;
+		clcpp::Database databases[NB_DATABASES];
+		clcpp::DatabaseHandle handle;
+		unsigned int reader = handle.AddReader();
+		if (!handle.Swap(&databases[0]))
+			return false;
+
+		// A reader holding the first database stops all the databases after it from being reclaimed
+		handle.BeginRead(reader);
+		for (unsigned int i = 1; i <= clcpp::DatabaseHandle::MAX_RETIRED; i++)
+		{
+			if (!handle.Swap(&databases[i]))
+				return false;
+		}
+
+		// Once full, swaps fail without changing the current database
+		unsigned int other_reader = handle.AddReader();
+		if (handle.Swap(&databases[NB_DATABASES - 1]))
+			return false;
+		const clcpp::Database* current = handle.BeginRead(other_reader);
+		handle.EndRead(other_reader);
+		if (current != &databases[clcpp::DatabaseHandle::MAX_RETIRED] || handle.Reclaim() != 0)
+			return false;
+
+		// Every retired database is reclaimed once the reader is done, making room for the swap
+		handle.EndRead(reader);
+		bool reclaimed[NB_DATABASES] = { false };
+		for (clcpp::Database* database = handle.Reclaim(); database != 0; database = handle.Reclaim())
+		{
+			if (database < databases || database >= databases + NB_DATABASES || reclaimed[database - databases])
+				return false;
+			reclaimed[database - databases] = true;
+		}
+		for (unsigned int i = 0; i < clcpp::DatabaseHandle::MAX_RETIRED; i++)
+		{
+			if (!reclaimed[i])
+				return false;
+		}
+		return !reclaimed[clcpp::DatabaseHandle::MAX_RETIRED] && handle.Swap(&databases[NB_DATABASES - 1]);
+	}
+}
+
+
+void TestDatabaseHandle(clcpp::Database& db)
+{
+	printf("---------------------\n");
+	printf("NAME: DatabaseHandle reader slots\n");
+	printf(TestReaderSlots() ? "PASS\n" : "FAIL\n");
+
+	printf("---------------------\n");
+	printf("NAME: DatabaseHandle swap\n");
+	printf(TestSwap() ? "PASS\n" : "FAIL\n");
+
+	printf("---------------------\n");
+	printf("NAME: DatabaseHandle retired limit\n");
+	printf(TestRetiredLimit() ? "PASS\n" : "FAIL\n");
+}
@@ -0,0 +1,68 @@
+//
+// ===============================================================================
+// clReflect, TestFile.h - File loading for tests that load their own databases
+// -------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 Don Williamson & clReflect Authors (see AUTHORS file)
+// Released under MIT License (see LICENSE file)
+// ===============================================================================
+//
+
+#pragma once
+
+
+#include <clcpp/clcpp.h>
+
+#include <stdio.h>
+#if defined(CLCPP_USING_MSVC)
+#include <malloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+
+class StdFile : public clcpp::IFile
+{
+public:
+	StdFile(const char* filename)
+	{
+		m_FP = fopen(filename, "rb");
+		if (m_FP == 0)
+		{
+			return;
+		}
+	}
+
+	~StdFile()
+	{
+		if (m_FP != 0)
+		{
+			fclose(m_FP);
+		}
+	}
+
+	bool IsOpen() const
+	{
+		return m_FP != 0;
+	}
+
+	bool Read(void* dest, clcpp::size_type size)
+	{
+		return fread(dest, 1, size, m_FP) == size;
+	}
+
+private:
+	FILE* m_FP;
+};
+
+
+class Malloc : public clcpp::IAllocator
+{
+	void* Alloc(clcpp::size_type size)
+	{
+		return malloc(size);
+	}
+	void Free(void* ptr)
+	{
+		free(ptr);
+	}
+};
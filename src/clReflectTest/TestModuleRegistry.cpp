@@ -0,0 +1,125 @@
+//
+// ===============================================================================
+// clReflect
+// -------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 Don Williamson & clReflect Authors (see AUTHORS file)
+// Released under MIT License (see LICENSE file)
+// ===============================================================================
+//
+
+#include "TestFile.h"
+
+#include <clutl/Module.h>
+
+#include <stdio.h>
+#include <vector>
+
+
+namespace
+{
+	// Enough extra types in each database to push the registry well past its initial 1024 entries
+	const unsigned int NB_EXTRA_TYPES = 1200;
+	const unsigned int FIRST_SHARED_TYPE = 400;
+	const unsigned int END_SHARED_TYPE = 800;
+
+
+	unsigned int ExtraTypeHash(unsigned int index)
+	{
+		char name[64];
+		sprintf(name, "ModuleRegistryTest::Type%d", index);
+		return clcpp::internal::HashNameString(name);
+	}
+
+
+	bool LoadWithTypes(clcpp::Database& db, clcpp::IAllocator& allocator, clcpp::Type* types, unsigned int begin,
+					   unsigned int end, std::vector<const clcpp::Type*>& type_list)
+	{
+		StdFile file("clReflectTest.cppbin");
+		if (!file.IsOpen() || !db.Load(&file, &allocator, 0))
+			return false;
+
+		// Each database has its own copy of every type in the test database, along with the extras
+		unsigned int nb_types = 0;
+		const clcpp::Type** db_types = db.GetTypes(nb_types);
+		type_list.assign(db_types, db_types + nb_types);
+		for (unsigned int i = begin; i < end; i++)
+		{
+			types[i].name.hash = ExtraTypeHash(i);
+			type_list.push_back(types + i);
+		}
+		db.SetTypes(type_list.data(), (unsigned int)type_list.size());
+		return true;
+	}
+
+
+	bool FindsTypes(const clutl::ModuleRegistry& registry, const std::vector<const clcpp::Type*>& type_list)
+	{
+		for (size_t i = 0; i < type_list.size(); i++)
+		{
+			if (registry.GetType(type_list[i]->name.hash) == 0)
+				return false;
+		}
+		return true;
+	}
+
+
+	bool TestAddRemove()
+	{
+		// Both databases contain the test database types and share the names of some of the extras
+		static clcpp::Type types_a[NB_EXTRA_TYPES], types_b[NB_EXTRA_TYPES];
+		std::vector<const clcpp::Type*> type_list_a, type_list_b;
+		Malloc allocator;
+		clcpp::Database db_a, db_b;
+		if (!LoadWithTypes(db_a, allocator, types_a, 0, END_SHARED_TYPE, type_list_a) ||
+			!LoadWithTypes(db_b, allocator, types_b, FIRST_SHARED_TYPE, NB_EXTRA_TYPES, type_list_b))
+			return false;
+
+		clutl::ModuleRegistry registry;
+		registry.AddDatabase(&db_a);
+		registry.AddDatabase(&db_b);
+		if (!FindsTypes(registry, type_list_a) || !FindsTypes(registry, type_list_b))
+			return false;
+
+		// Types only in the removed database are gone, while shared names find the survivor
+		registry.RemoveDatabase(&db_a);
+		for (unsigned int i = 0; i < NB_EXTRA_TYPES; i++)
+		{
+			const clcpp::Type* expected = i < FIRST_SHARED_TYPE ? 0 : types_b + i;
+			if (registry.GetType(ExtraTypeHash(i)) != expected)
+				return false;
+		}
+		unsigned int nb_types = 0;
+		const clcpp::Type** types = db_b.GetTypes(nb_types);
+		for (unsigned int i = 0; i < nb_types; i++)
+		{
+			if (registry.GetType(types[i]->name.hash) != types[i])
+				return false;
+		}
+
+		// Adding back over the removed entries finds the original types again
+		registry.AddDatabase(&db_a);
+		for (unsigned int i = 0; i < FIRST_SHARED_TYPE; i++)
+		{
+			if (registry.GetType(ExtraTypeHash(i)) != types_a + i)
+				return false;
+		}
+
+		// Removing everything leaves nothing to find
+		registry.RemoveDatabase(&db_b);
+		registry.RemoveDatabase(&db_a);
+		for (unsigned int i = 0; i < NB_EXTRA_TYPES; i++)
+		{
+			if (registry.GetType(ExtraTypeHash(i)) != 0)
+				return false;
+		}
+		return registry.GetType(types[0]->name.hash) == 0;
+	}
+}
+
+
+void TestModuleRegistry(clcpp::Database& db)
+{
+	printf("---------------------\n");
+	printf("NAME: ModuleRegistry\n");
+	printf(TestAddRemove() ? "PASS\n" : "FAIL\n");
+}
@@ -8,11 +8,20 @@
 // ===============================================================================
 //
 
+#include "TestFile.h"
+
 #include <clcpp/clcpp.h>
+#include <clutl/JSONLexer.h>
 #include <clutl/Serialise.h>
+#include <clutl/STLContainers.h>
 
+#include <float.h>
+#include <map>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <string>
+#include <vector>
 
 
 namespace
@@ -38,7 +47,7 @@ namespace
 		write_buffer.Write(test, strlen(test));
 		clutl::ReadBuffer read_buffer(write_buffer);
 
-		clutl::JSONError error = clutl::LoadJSON(read_buffer, 0, (clcpp::Type*)0);
+		clutl::JSONError error = clutl::LoadJSON(read_buffer, 0, (clcpp::Type*)0, 0);
 		if (error.code == clutl::JSONError::NONE)
 		{
 			printf("PASS\n");
@@ -336,6 +345,427 @@ namespace jsontest
 			return true;
 		}
 	};
+
+	struct Containers
+	{
+		bool operator == (const Containers& rhs) const
+		{
+			if (ints != rhs.ints)
+				return false;
+			if (text != rhs.text)
+				return false;
+			if (nested.size() != rhs.nested.size())
+				return false;
+			for (size_t i = 0; i < nested.size(); i++)
+			{
+				if (!(nested[i] == rhs.nested[i]))
+					return false;
+			}
+			if (map.size() != rhs.map.size())
+				return false;
+			for (std::map<int, NestedStruct>::const_iterator i = map.begin(), j = rhs.map.begin(); i != map.end(); ++i, ++j)
+			{
+				if (i->first != j->first || !(i->second == j->second))
+					return false;
+			}
+
+			return true;
+		}
+
+		std::vector<int> ints;
+		std::string text;
+		std::vector<NestedStruct> nested;
+		std::map<int, NestedStruct> map;
+	};
+
+	struct Numbers
+	{
+		double d;
+		float f;
+		clcpp::int64 i;
+	};
+}
+
+
+clcpp_reflect(std::vector)
+clcpp_reflect(std::basic_string)
+clcpp_reflect(std::map)
+clutl_std_vector_iterators(IntVector, std::vector<int,std::allocator<int>>)
+clutl_std_vector_iterators(String, std::basic_string<char,std::char_traits<char>,std::allocator<char>>)
+clutl_std_vector_iterators(NestedVector, std::vector<jsontest::NestedStruct,std::allocator<jsontest::NestedStruct>>)
+clutl_std_map_iterators(IntNestedMap, std::map<int,jsontest::NestedStruct,std::less<int>,std::allocator<std::pair<const int,jsontest::NestedStruct>>>)
+
+
+namespace
+{
+	void Check(const char* name, bool pass)
+	{
+		printf("%s %s!\n", name, pass ? "PASS" : "FAIL");
+	}
+
+
+	// Hands out at most max_read bytes on each read, to split the input at every possible position
+	struct ChunkedSource : public clutl::IReadSource
+	{
+		ChunkedSource(const char* data, unsigned int size, unsigned int max_read)
+			: data(data)
+			, size(size)
+			, position(0)
+			, max_read(max_read)
+		{
+		}
+
+		unsigned int Read(void* dest, unsigned int dest_size)
+		{
+			unsigned int length = size - position;
+			length = length < dest_size ? length : dest_size;
+			length = length < max_read ? length : max_read;
+			memcpy(dest, data + position, length);
+			position += length;
+			return length;
+		}
+
+		const char* data;
+		unsigned int size;
+		unsigned int position;
+		unsigned int max_read;
+	};
+
+
+	// Collects everything written, optionally failing one of the writes
+	struct StringSink : public clutl::IWriteSink
+	{
+		StringSink(int fail_at)
+			: nb_writes(0)
+			, fail_at(fail_at)
+		{
+		}
+
+		bool Write(const void* data, unsigned int length)
+		{
+			if (nb_writes++ == fail_at)
+				return false;
+			text.append((const char*)data, length);
+			return true;
+		}
+
+		std::string text;
+		int nb_writes;
+		int fail_at;
+	};
+
+
+	bool TokensEqual(const clutl::JSONToken& a, const clutl::JSONToken& b)
+	{
+		if (a.type != b.type || a.length != b.length)
+			return false;
+
+		switch (a.type)
+		{
+		case (clutl::JSON_TOKEN_STRING): return memcmp(a.val.string, b.val.string, a.length) == 0;
+		case (clutl::JSON_TOKEN_INTEGER): return a.val.integer == b.val.integer;
+		case (clutl::JSON_TOKEN_DECIMAL): return a.val.decimal == b.val.decimal;
+		default: return true;
+		}
+	}
+
+
+	bool StreamMatchesBuffer(const char* json, unsigned int chunk_size)
+	{
+		// Lex the input in memory and streamed side by side, comparing each token before the next one
+		// is allowed to retire the streamed input it refers to
+		unsigned int length = strlen(json);
+		clutl::ReadBuffer read_buffer(json, length);
+		clutl::JSONContext buffer_ctx(read_buffer);
+		ChunkedSource source(json, length, chunk_size);
+		clutl::JSONContext stream_ctx(source, chunk_size);
+
+		while (true)
+		{
+			clutl::JSONToken a = clutl::LexerNextToken(buffer_ctx);
+			clutl::JSONToken b = clutl::LexerNextToken(stream_ctx);
+			if (!TokensEqual(a, b))
+				return false;
+			if (!a.IsValid())
+				break;
+		}
+
+		clutl::JSONError a = buffer_ctx.GetError();
+		clutl::JSONError b = stream_ctx.GetError();
+		return a.code == b.code && a.line == b.line && a.column == b.column;
+	}
+
+
+	void TestStreaming()
+	{
+		// Tokens of every kind, with strings and numbers longer than the smaller chunk sizes
+		const char* json =
+			"{ \"string\" : \"a string long enough to span several chunks with \\\" \\\\ \\n \\u0123 escapes\",\n"
+			"  \"integers\" : [ 0, -1, 1234567890123, -9223372036854775807 ],\r\n"
+			"  \"decimals\" : [ 0.5, -123.123e-4, 1.7976931348623157e+308, 4.9406564584124654e-324 ],\n"
+			"\t\"keywords\" : [ true, false, null ], \"nested\" : { \"empty\" : { }, \"array\" : [ [ ] ] } }";
+
+		// Input ending mid-token fails the same way, at the same position
+		const char* truncated = "{ \"value\" : [ 1, 2.5, \"abc";
+
+		bool pass = true;
+		for (unsigned int chunk_size = 1; chunk_size < 70; chunk_size++)
+		{
+			pass &= StreamMatchesBuffer(json, chunk_size);
+			pass &= StreamMatchesBuffer(truncated, chunk_size);
+		}
+		Check("STREAM TOKENS", pass);
+
+		// Whole objects load the same from a stream, including arrays that need a counting pre-pass
+		clutl::WriteBuffer write_buffer;
+		jsontest::AllFields a;
+		clutl::SaveJSON(write_buffer, &a, clcpp::GetType<jsontest::AllFields>(), 0, clutl::JSONFlags::FORMAT_OUTPUT, 0);
+		pass = true;
+		for (unsigned int chunk_size = 1; chunk_size < 70; chunk_size++)
+		{
+			ChunkedSource source(write_buffer.GetData(), write_buffer.GetBytesWritten(), chunk_size);
+			jsontest::AllFields b(jsontest::NO_INIT);
+			clutl::JSONError error = clutl::LoadJSON(source, &b, clcpp::GetType<jsontest::AllFields>(), 0, chunk_size);
+			pass &= error.code == clutl::JSONError::NONE && a == b;
+		}
+		Check("STREAM STRUCT", pass);
+	}
+
+
+	void TestWriteSink()
+	{
+		clutl::WriteBuffer write_buffer;
+		jsontest::AllFields a;
+		clutl::SaveJSON(write_buffer, &a, clcpp::GetType<jsontest::AllFields>(), 0, clutl::JSONFlags::FORMAT_OUTPUT, 0);
+		std::string expected(write_buffer.GetData(), write_buffer.GetBytesWritten());
+
+		// Output is the same however it's split into chunks
+		bool pass = true;
+		unsigned int chunk_sizes[] = { 1, 7, 64, 64 * 1024 };
+		for (unsigned int i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++)
+		{
+			StringSink sink(-1);
+			const clcpp::Type* type = clcpp::GetType<jsontest::AllFields>();
+			pass &= clutl::SaveJSON(sink, &a, type, 0, clutl::JSONFlags::FORMAT_OUTPUT, 0, chunk_sizes[i]);
+			pass &= sink.text == expected;
+		}
+		Check("SINK", pass);
+
+		// A failed write fails the save and nothing more is passed on after it
+		StringSink sink(2);
+		pass = !clutl::SaveJSON(sink, &a, clcpp::GetType<jsontest::AllFields>(), 0, clutl::JSONFlags::FORMAT_OUTPUT, 0, 16);
+		pass &= sink.nb_writes == 3;
+		Check("SINK FAILURE", pass);
+	}
+
+
+	bool LoadContainers(const char* json, jsontest::Containers& containers)
+	{
+		clutl::ReadBuffer read_buffer(json, strlen(json));
+		clutl::JSONError error = clutl::LoadJSON(read_buffer, &containers, clcpp::GetType<jsontest::Containers>(), 0);
+		return error.code == clutl::JSONError::NONE;
+	}
+
+
+	void TestContainers()
+	{
+		jsontest::Containers a;
+		for (int i = 0; i < 100; i++)
+			a.ints.push_back(i * 7 - 50);
+		a.text = "a string that doesn't fit in small string storage";
+		a.nested.resize(3);
+		a.nested[1].x = 10;
+		a.map[-4].y = 0.25;
+		a.map[17].z = 9;
+
+		// Round trip through the standard library iterators, with and without counts
+		unsigned int flags[] = { 0, clutl::JSONFlags::EMIT_CONTAINER_COUNTS };
+		for (unsigned int i = 0; i < sizeof(flags) / sizeof(flags[0]); i++)
+		{
+			clutl::WriteBuffer write_buffer;
+			clutl::SaveJSON(write_buffer, &a, clcpp::GetType<jsontest::Containers>(), 0, flags[i], 0);
+			clutl::ReadBuffer read_buffer(write_buffer);
+			jsontest::Containers b;
+			b.ints.push_back(1);
+			b.map[1];
+			clutl::JSONError error = clutl::LoadJSON(read_buffer, &b, clcpp::GetType<jsontest::Containers>(), 0);
+			Check(flags[i] ? "STL COUNTS" : "STL", error.code == clutl::JSONError::NONE && a == b);
+		}
+
+		// Counts only reserve space in containers that grow, so they load exactly the values in the
+		// array whether the count is short, too long or out of range
+		bool pass = true;
+		jsontest::Containers b;
+		pass &= LoadContainers("{ \"ints\" : [ { \"$n\" : 1 }, 1, 2, 3 ] }", b);
+		pass &= b.ints.size() == 3 && b.ints[0] == 1 && b.ints[2] == 3;
+		jsontest::Containers c;
+		pass &= LoadContainers("{ \"ints\" : [ { \"$n\" : 4294967297 }, 1, 2, 3 ] }", c);
+		pass &= c.ints == b.ints;
+		jsontest::Containers d;
+		pass &= LoadContainers("{ \"ints\" : [ {\"$n\":3},1,2,3 ], \"text\" : [ { \"$n\" : 0 } ] }", d);
+		pass &= d.ints == b.ints && d.text.empty();
+		jsontest::Containers e;
+		pass &= LoadContainers("{ \"ints\" : [ { \"$n\" : 5 }, 1, 2, 3 ] }", e);
+		pass &= e.ints == b.ints;
+		jsontest::Containers f;
+		pass &= LoadContainers("{ \"ints\" : [ { \"$n\" : 2147483647 }, 1, 2, 3 ] }", f);
+		pass &= f.ints == b.ints && f.ints.capacity() < 1000;
+		Check("STL COUNT HINTS", pass);
+	}
+
+
+	bool SavesAs(double d, float f, clcpp::int64 i, const char* expected)
+	{
+		jsontest::Numbers numbers;
+		numbers.d = d;
+		numbers.f = f;
+		numbers.i = i;
+		clutl::WriteBuffer write_buffer;
+		clutl::SaveJSON(write_buffer, &numbers, clcpp::GetType<jsontest::Numbers>(), 0,
+						clutl::JSONFlags::SORT_CLASS_FIELDS_BY_OFFSET, 0);
+		if (write_buffer.GetBytesWritten() != strlen(expected) ||
+			memcmp(write_buffer.GetData(), expected, strlen(expected)) != 0)
+			return false;
+
+		// Anything that can be represented loads back exactly
+		if (d != d || f != f)
+			return true;
+		clutl::ReadBuffer read_buffer(write_buffer);
+		jsontest::Numbers loaded;
+		clutl::LoadJSON(read_buffer, &loaded, clcpp::GetType<jsontest::Numbers>(), 0);
+		return memcmp(&loaded.d, &d, sizeof(d)) == 0 && memcmp(&loaded.f, &f, sizeof(f)) == 0 && loaded.i == i;
+	}
+
+
+	bool LexesAs(const char* text, clutl::JSONTokenType type, double expected)
+	{
+		// Numbers at the end of the input are incomplete, so terminate them
+		std::string input = std::string(text) + " ";
+		clutl::ReadBuffer read_buffer(input.c_str(), input.size());
+		clutl::JSONContext ctx(read_buffer);
+		clutl::JSONToken token = clutl::LexerNextToken(ctx);
+		if (token.type != type)
+			return false;
+		if (type == clutl::JSON_TOKEN_INTEGER)
+			return token.val.integer == (clcpp::int64)expected;
+		return memcmp(&token.val.decimal, &expected, sizeof(expected)) == 0;
+	}
+
+
+	bool LexesAs(const char* text, clcpp::int64 expected)
+	{
+		// Numbers at the end of the input are incomplete, so terminate them
+		std::string input = std::string(text) + " ";
+		clutl::ReadBuffer read_buffer(input.c_str(), input.size());
+		clutl::JSONContext ctx(read_buffer);
+		clutl::JSONToken token = clutl::LexerNextToken(ctx);
+		return token.type == clutl::JSON_TOKEN_INTEGER && token.val.integer == expected;
+	}
+
+
+	void TestNumbers()
+	{
+		// Shortest digits that load back as the same value, including those Grisu3 can't be sure of
+		// and hands over to printf
+		bool pass = true;
+		pass &= SavesAs(0.1, 0.1f, 0, "{\"d\":0.1,\"f\":0.1,\"i\":0}");
+		pass &= SavesAs(5e-324, 1e-45f, 1, "{\"d\":5e-324,\"f\":1e-45,\"i\":1}");
+		pass &= SavesAs(DBL_MAX, FLT_MAX, -1, "{\"d\":1.7976931348623157e+308,\"f\":3.4028235e+38,\"i\":-1}");
+		pass &= SavesAs(1e23, 100.0f, 12345678, "{\"d\":1e+23,\"f\":100.0,\"i\":12345678}");
+		pass &= SavesAs(-0.0, 16777216.0f, -9223372036854775807LL - 1,
+						"{\"d\":-0.0,\"f\":16777216.0,\"i\":-9223372036854775808}");
+		pass &= SavesAs(9007199254740993.0, 1e-7f, 9223372036854775807LL,
+						"{\"d\":9.007199254740992e+15,\"f\":1e-07,\"i\":9223372036854775807}");
+
+		// Infinities and NaNs have no JSON representation
+		double zero = 0;
+		pass &= SavesAs(zero / zero, (float)(1 / zero), 0, "{\"d\":null,\"f\":null,\"i\":0}");
+		Check("SAVE NUMBERS", pass);
+
+		// Integers convert 8 digits at a time when there are enough of them, with the rest one at a time
+		pass = true;
+		pass &= LexesAs("7", 7);
+		pass &= LexesAs("12345678", 12345678);
+		pass &= LexesAs("-123456789", -123456789);
+		pass &= LexesAs("1234567890123456789", 1234567890123456789LL);
+		pass &= LexesAs("9223372036854775807", 9223372036854775807LL);
+		pass &= LexesAs("-9223372036854775808", -9223372036854775807LL - 1);
+		pass &= LexesAs("12345678.87654321e-3", clutl::JSON_TOKEN_DECIMAL, 12345678.87654321e-3);
+		Check("LEX INTEGERS", pass);
+
+		// Decimals that can't be converted quickly from 64-bit mantissas fall back to strtod
+		const char* decimals[] = {
+			"0.1", "5e-324", "4.9406564584124654e-324", "2.2250738585072011e-308", "1.7976931348623157e+308",
+			"9007199254740993.0", "123456789012345678901234567890.5", "0.000000000000000000000000000001234567",
+			"7.2057594037927933e16", "1e400", "-1e-400",
+		};
+		pass = true;
+		for (unsigned int i = 0; i < sizeof(decimals) / sizeof(decimals[0]); i++)
+			pass &= LexesAs(decimals[i], clutl::JSON_TOKEN_DECIMAL, strtod(decimals[i], 0));
+		Check("LEX DECIMALS", pass);
+	}
+
+
+	bool LoadOnDemand(clcpp::Database& db, clcpp::IAllocator& allocator)
+	{
+		StdFile file("clReflectTest.cppbin");
+		return file.IsOpen() && db.Load(&file, &allocator, clcpp::Database::OPT_LOAD_SECTIONS_ON_DEMAND);
+	}
+
+
+	bool SavesSameJSON(const jsontest::AllFields& object, const clcpp::Type* type, const clcpp::Type* lazy_type)
+	{
+		clutl::WriteBuffer write_buffer, lazy_write_buffer;
+		clutl::SaveJSON(write_buffer, &object, type, 0, clutl::JSONFlags::EMIT_HEX_FLOATS, 0);
+		clutl::SaveJSON(lazy_write_buffer, &object, lazy_type, 0, clutl::JSONFlags::EMIT_HEX_FLOATS, 0);
+		return write_buffer.GetBytesWritten() == lazy_write_buffer.GetBytesWritten() &&
+			memcmp(write_buffer.GetData(), lazy_write_buffer.GetData(), write_buffer.GetBytesWritten()) == 0;
+	}
+
+
+	void TestOnDemandSections(clcpp::Database& db)
+	{
+		// Only the core section is loaded up-front
+		Malloc allocator;
+		clcpp::Database lazy_db;
+		bool pass = LoadOnDemand(lazy_db, allocator);
+		pass = pass && lazy_db.IsSectionLoaded(clcpp::Database::SECTION_CORE);
+		pass = pass && !lazy_db.IsSectionLoaded(clcpp::Database::SECTION_NAMES);
+		pass = pass && !lazy_db.IsSectionLoaded(clcpp::Database::SECTION_FUNCTIONS);
+		pass = pass && !lazy_db.IsSectionLoaded(clcpp::Database::SECTION_ATTRIBUTES);
+
+		// Lookups load the sections they need
+		unsigned int nb_functions = 0;
+		const clcpp::Function* functions = db.GetFunctions(nb_functions);
+		if (pass && nb_functions != 0)
+		{
+			const clcpp::Function* function = lazy_db.GetFunction(functions[0].name.hash);
+			pass = function != 0 && function->name.hash == functions[0].name.hash;
+			pass = pass && lazy_db.IsSectionLoaded(clcpp::Database::SECTION_FUNCTIONS);
+		}
+		clcpp::Name name = pass ? lazy_db.GetName("jsontest::AllFields") : clcpp::Name();
+		pass = pass && name.text != 0 && strcmp(name.text, "jsontest::AllFields") == 0;
+		pass = pass && lazy_db.IsSectionLoaded(clcpp::Database::SECTION_NAMES);
+		Check("ON DEMAND SECTIONS", pass);
+
+		// The serialisers load whatever they need from a fresh database to match the fully loaded one
+		clcpp::Database json_db;
+		const clcpp::Type* type = clcpp::GetType<jsontest::AllFields>();
+		pass = LoadOnDemand(json_db, allocator);
+		const clcpp::Type* lazy_type = pass ? json_db.GetType(type->name.hash) : 0;
+		jsontest::AllFields a;
+		pass = lazy_type != 0 && SavesSameJSON(a, type, lazy_type);
+		if (pass)
+		{
+			clutl::WriteBuffer write_buffer;
+			clutl::SaveJSON(write_buffer, &a, lazy_type, 0, clutl::JSONFlags::EMIT_HEX_FLOATS, 0);
+			clutl::ReadBuffer read_buffer(write_buffer);
+			jsontest::AllFields b(jsontest::NO_INIT);
+			clutl::JSONError error = clutl::LoadJSON(read_buffer, &b, lazy_type, 0);
+			pass = error.code == clutl::JSONError::NONE && a == b;
+		}
+		Check("ON DEMAND JSON", pass);
+	}
 }
 
 
@@ -414,13 +844,19 @@ void TestSerialiseJSON(clcpp::Database& db)
 
 	clutl::WriteBuffer write_buffer;
 	jsontest::AllFields a;
-	clutl::SaveJSON(write_buffer, &a, clcpp::GetType<jsontest::AllFields>(), 0, clutl::JSONFlags::EMIT_HEX_FLOATS);
+	clutl::SaveJSON(write_buffer, &a, clcpp::GetType<jsontest::AllFields>(), 0, clutl::JSONFlags::EMIT_HEX_FLOATS, 0);
 	clutl::ReadBuffer read_buffer(write_buffer);
 	jsontest::AllFields b(jsontest::NO_INIT);
-	clutl::LoadJSON(read_buffer, &b, clcpp::GetType<jsontest::AllFields>());
+	clutl::LoadJSON(read_buffer, &b, clcpp::GetType<jsontest::AllFields>(), 0);
 
 	if (a == b)
 		printf("STRUCT PASS!\n");
 	else
 		printf("STRUCT FAIL!\n");
+
+	TestStreaming();
+	TestWriteSink();
+	TestContainers();
+	TestNumbers();
+	TestOnDemandSections(db);
 }
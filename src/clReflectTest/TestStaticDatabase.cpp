@@ -0,0 +1,192 @@
+//
+// ===============================================================================
+// clReflect
+// -------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 Don Williamson & clReflect Authors (see AUTHORS file)
+// Released under MIT License (see LICENSE file)
+// ===============================================================================
+//
+
+#include "TestFile.h"
+
+#include <clcpp/clcpp.h>
+#include <clcpp/clcpp_internal.h>
+#include <clutl/Serialise.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+
+// Generated by clexport -cpp_src from the same reflection data as clReflectTest.cppbin, with function
+// addresses from the map file of the stage executable
+extern const void* const clcppStaticDatabase[];
+
+
+// Serialised through the static database, which needs the container iterators' constructors
+clcpp_reflect(staticdb)
+clcpp_reflect(std::vector)
+namespace staticdb
+{
+	struct VectorFields
+	{
+		int id;
+		std::vector<int> values;
+	};
+}
+
+
+namespace
+{
+	bool SameFields(const clcpp::Class* a, const clcpp::Class* b)
+	{
+		if (a->all_fields.size != b->all_fields.size)
+			return false;
+
+		for (unsigned int i = 0; i < a->all_fields.size; i++)
+		{
+			const clcpp::Field* fa = a->all_fields[i];
+			const clcpp::Field* fb = b->all_fields[i];
+			if (fa->name.hash != fb->name.hash || strcmp(fa->name.text, fb->name.text) != 0 ||
+				fa->offset != fb->offset || fa->type->name.hash != fb->type->name.hash)
+				return false;
+		}
+
+		return true;
+	}
+
+
+	bool SameType(const clcpp::Type* a, const clcpp::Type* b)
+	{
+		if (b == 0 || a->kind != b->kind || a->size != b->size || strcmp(a->name.text, b->name.text) != 0)
+			return false;
+
+		if (a->kind == clcpp::Primitive::KIND_CLASS)
+			return SameFields(a->AsClass(), b->AsClass());
+
+		if (a->kind == clcpp::Primitive::KIND_ENUM)
+		{
+			const clcpp::Enum* ea = a->AsEnum();
+			const clcpp::Enum* eb = b->AsEnum();
+			if (ea->constants.size != eb->constants.size)
+				return false;
+			for (unsigned int i = 0; i < ea->constants.size; i++)
+			{
+				if (ea->constants[i]->value != eb->constants[i]->value ||
+					strcmp(eb->GetValueName(ea->constants[i]->value), ea->GetValueName(ea->constants[i]->value)) != 0)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+
+	bool SameTypes(const clcpp::Database& db, const clcpp::Database& other_db)
+	{
+		// Every type must match the one loaded from file
+		unsigned int nb_types = 0, nb_other_types = 0;
+		const clcpp::Type** types = db.GetTypes(nb_types);
+		other_db.GetTypes(nb_other_types);
+		if (nb_types != nb_other_types)
+			return false;
+
+		for (unsigned int i = 0; i < nb_types; i++)
+		{
+			const clcpp::Type* type = types[i];
+			if (!SameType(type, other_db.GetType(type->name.hash)))
+			{
+				printf("FAIL: %s differs\n", type->name.text);
+				return false;
+			}
+		}
+
+		// Only the number of functions is compared as their addresses depend on how they were loaded
+		unsigned int nb_functions = 0, nb_other_functions = 0;
+		db.GetFunctions(nb_functions);
+		other_db.GetFunctions(nb_other_functions);
+		return nb_functions == nb_other_functions;
+	}
+
+
+	bool RoundTripVector(const clcpp::Database& static_db)
+	{
+		const clcpp::Type* type = static_db.GetType(clcpp::internal::HashNameString("staticdb::VectorFields"));
+		if (type == 0)
+			return false;
+
+		staticdb::VectorFields a;
+		a.id = 7;
+		for (int i = 0; i < 10; i++)
+			a.values.push_back(i * i - 20);
+
+		clutl::WriteBuffer write_buffer;
+		clutl::SaveJSON(write_buffer, &a, type, 0, 0, 0);
+		clutl::ReadBuffer read_buffer(write_buffer);
+		staticdb::VectorFields b;
+		b.id = 0;
+		clutl::JSONError error = clutl::LoadJSON(read_buffer, &b, type, 0);
+		return error.code == clutl::JSONError::NONE && b.id == a.id && b.values == a.values;
+	}
+}
+
+
+void TestStaticDatabase(clcpp::Database& db)
+{
+	printf("---------------------\n");
+	printf("NAME: LoadStatic\n");
+
+	clcpp::Database static_db;
+	if (!static_db.LoadStatic(clcppStaticDatabase))
+	{
+		printf("FAIL: Couldn't load the static database\n");
+		return;
+	}
+
+	// All pointers are resolved by the linker, and names and functions are reachable from the static
+	// database without loading anything
+	bool pass = SameTypes(db, static_db);
+	clcpp::Name name = static_db.GetName("jsontest::BaseStruct");
+	pass = pass && name.text != 0 && strcmp(name.text, "jsontest::BaseStruct") == 0;
+	pass = pass && static_db.GetGlobalNamespace()->namespaces.size == db.GetGlobalNamespace()->namespaces.size;
+
+	// Containers are created through the rebased constructors of their iterators
+	if (pass && !RoundTripVector(static_db))
+	{
+		printf("FAIL: std::vector field didn't round trip through JSON\n");
+		pass = false;
+	}
+
+	// Unloading only forgets the array, which is owned by the executable
+	pass = pass && static_db.UnLoad() && !static_db.IsLoaded();
+
+	printf(pass ? "PASS\n" : "FAIL\n");
+}
+
+
+void TestCompressedDatabase(clcpp::Database& db)
+{
+	printf("---------------------\n");
+	printf("NAME: Compressed\n");
+
+	// Exported with -cpp_compress from the same reflection data as clReflectTest.cppbin
+	StdFile header_file("clReflectTestCompressed.cppbin");
+	clcpp::internal::DatabaseFileHeader header;
+	if (!header_file.IsOpen() || !header_file.Read(&header, sizeof(header)) || header.compression_block_size == 0)
+	{
+		printf("FAIL: Couldn't read a compressed database header\n");
+		return;
+	}
+
+	// Decompressed while it's read
+	StdFile file("clReflectTestCompressed.cppbin");
+	Malloc allocator;
+	clcpp::Database compressed_db;
+	if (!compressed_db.Load(&file, &allocator, 0))
+	{
+		printf("FAIL: Couldn't load the compressed database\n");
+		return;
+	}
+
+	printf(SameTypes(db, compressed_db) ? "PASS\n" : "FAIL\n");
+}
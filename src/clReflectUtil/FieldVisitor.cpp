@@ -59,6 +59,22 @@ namespace
 	{
 		// Visit each entry in the container - keys are discarded
 		clcpp::Qualifier qualifer(reader.m_ValueIsPtr ? clcpp::Qualifier::POINTER : clcpp::Qualifier::VALUE, false);
+
+		// Containers of plain values have nothing to visit when only pointers are requested
+		if (visit_type == clutl::VFT_Pointers && !reader.m_ValueIsPtr &&
+			(reader.m_ValueType->kind == clcpp::Primitive::KIND_TYPE || reader.m_ValueType->kind == clcpp::Primitive::KIND_ENUM))
+			return;
+
+		// Values stored contiguously can be walked without calling back into the iterator
+		clcpp::ContainerSpan span;
+		if (reader.GetContiguous(span))
+		{
+			char* value = (char*)span.data;
+			for (unsigned int i = 0; i < span.count; i++, value += span.stride)
+				VisitField(value, field, reader.m_ValueType, qualifer, visitor, visit_type, stop_flags);
+			return;
+		}
+
 		for (unsigned int i = 0; i < reader.m_Count; i++)
 		{
 			clcpp::ContainerKeyValue kv = reader.GetKeyValue();
@@ -86,10 +102,25 @@ namespace
 	}
 
 
+	void VisitBaseContainers(char* object, const clcpp::Type* type, const clutl::IFieldVisitor& visitor, clutl::VisitFieldType visit_type, unsigned int stop_flags)
+	{
+		// Template type bases registered as containers have entries to visit; all other
+		// bases only contribute fields, which are already flattened into the class
+		for (unsigned int i = 0; i < type->base_types.size; i++)
+		{
+			const clcpp::Type* base_type = type->base_types[i];
+			if (base_type->kind == clcpp::Primitive::KIND_TEMPLATE_TYPE && base_type->ci != 0)
+				VisitTemplateTypeFields(object, 0, base_type->AsTemplateType(), visitor, visit_type, stop_flags);
+			else
+				VisitBaseContainers(object, base_type, visitor, visit_type, stop_flags);
+		}
+	}
+
+
 	void VisitClassFields(char* object, const clcpp::Class* class_type, const clutl::IFieldVisitor& visitor, clutl::VisitFieldType visit_type, unsigned int stop_flags)
 	{
-		// Visit all fields in the class
-		const clcpp::CArray<const clcpp::Field*>& fields = class_type->fields;
+		// Visit all fields in the class hierarchy
+		const clcpp::CArray<const clcpp::Field*>& fields = class_type->all_fields;
 		for (unsigned int i = 0; i < fields.size; i++)
 		{
 			const clcpp::Field* field = fields[i];
@@ -107,9 +138,8 @@ namespace
 			VisitField(object + field->offset, field, field->type, field->qualifier, visitor, visit_type, stop_flags);
 		}
 
-		// Visit the base types at the same offset
-		for (unsigned int i = 0; i < class_type->base_types.size; i++)
-			VisitField(object, 0, class_type->base_types[i], clcpp::Qualifier(), visitor, visit_type, stop_flags);
+		// Visit any containers the class derives from at the same offset
+		VisitBaseContainers(object, class_type, visitor, visit_type, stop_flags);
 	}
 }
 
@@ -11,6 +11,24 @@
 #include <clutl/JSONLexer.h>
 
 
+// Pick the widest vector instruction set the compiler is targeting for classifying input
+// blocks, falling back to scalar code if there are none
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define CLUTL_JSON_AVX2
+	#define CLUTL_JSON_SIMD
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define CLUTL_JSON_SSE2
+	#define CLUTL_JSON_SIMD
+#endif
+
+// Bit scans and wide multiplies
+#if defined(CLCPP_USING_MSVC)
+	#include <intrin.h>
+#endif
+
+
 // Standard C library function, convert string to double-precision number
 // http://pubs.opengroup.org/onlinepubs/007904975/functions/strtod.html
 extern "C" double strtod(const char* s00, char** se);
@@ -26,6 +44,202 @@ namespace
 	{
 		return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f');
 	}
+	bool iswhitespace(char c)
+	{
+		return c == ' ' || (c >= '\t' && c <= '\r');
+	}
+
+
+	void CopyBytes(char* dest, const char* src, unsigned int size)
+	{
+		for (unsigned int i = 0; i < size; i++)
+			dest[i] = src[i];
+	}
+
+
+#if defined(CLUTL_JSON_SIMD)
+
+	//
+	// Lexing of long strings and whitespace runs is done in two stages. The first classifies
+	// a 64-byte block of input at a time with vector instructions, producing a bit mask with
+	// one bit per byte for the characters of interest. The second uses bit scans on those
+	// masks to skip directly to the next character that ends the run.
+	//
+	const unsigned int BLOCK_SIZE = 64;
+
+
+	unsigned int FirstBit(clcpp::uint64 mask)
+	{
+	#if defined(CLCPP_USING_MSVC)
+		// Split into 32-bit scans so that this also works on 32-bit platforms
+		unsigned long index;
+		if (_BitScanForward(&index, (unsigned long)mask))
+			return index;
+		_BitScanForward(&index, (unsigned long)(mask >> 32));
+		return 32 + index;
+	#else
+		return __builtin_ctzll(mask);
+	#endif
+	}
+
+
+	#if defined(CLUTL_JSON_AVX2)
+
+	struct Block
+	{
+		explicit Block(const char* data)
+		{
+			v[0] = _mm256_loadu_si256((const __m256i*)data);
+			v[1] = _mm256_loadu_si256((const __m256i*)(data + 32));
+		}
+
+		static clcpp::uint64 Mask(__m256i lo, __m256i hi)
+		{
+			return (clcpp::uint64)(unsigned int)_mm256_movemask_epi8(lo) | ((clcpp::uint64)(unsigned int)_mm256_movemask_epi8(hi) << 32);
+		}
+
+		clcpp::uint64 Equals(char c) const
+		{
+			__m256i cv = _mm256_set1_epi8(c);
+			return Mask(_mm256_cmpeq_epi8(v[0], cv), _mm256_cmpeq_epi8(v[1], cv));
+		}
+
+		clcpp::uint64 Whitespace() const
+		{
+			// Space or any of the contiguous range \t, \n, \v, \f, \r
+			__m256i space = _mm256_set1_epi8(' ');
+			__m256i first = _mm256_set1_epi8('\t');
+			__m256i range = _mm256_set1_epi8('\r' - '\t');
+			__m256i ws[2];
+			for (int i = 0; i < 2; i++)
+			{
+				__m256i x = _mm256_sub_epi8(v[i], first);
+				ws[i] = _mm256_or_si256(_mm256_cmpeq_epi8(v[i], space), _mm256_cmpeq_epi8(_mm256_min_epu8(x, range), x));
+			}
+			return Mask(ws[0], ws[1]);
+		}
+
+		__m256i v[2];
+	};
+
+	#else
+
+	struct Block
+	{
+		explicit Block(const char* data)
+		{
+			for (int i = 0; i < 4; i++)
+				v[i] = _mm_loadu_si128((const __m128i*)(data + i * 16));
+		}
+
+		static clcpp::uint64 Mask(const __m128i* m)
+		{
+			return (clcpp::uint64)(unsigned int)_mm_movemask_epi8(m[0]) |
+				((clcpp::uint64)(unsigned int)_mm_movemask_epi8(m[1]) << 16) |
+				((clcpp::uint64)(unsigned int)_mm_movemask_epi8(m[2]) << 32) |
+				((clcpp::uint64)(unsigned int)_mm_movemask_epi8(m[3]) << 48);
+		}
+
+		clcpp::uint64 Equals(char c) const
+		{
+			__m128i cv = _mm_set1_epi8(c);
+			__m128i eq[4];
+			for (int i = 0; i < 4; i++)
+				eq[i] = _mm_cmpeq_epi8(v[i], cv);
+			return Mask(eq);
+		}
+
+		clcpp::uint64 Whitespace() const
+		{
+			// Space or any of the contiguous range \t, \n, \v, \f, \r
+			__m128i space = _mm_set1_epi8(' ');
+			__m128i first = _mm_set1_epi8('\t');
+			__m128i range = _mm_set1_epi8('\r' - '\t');
+			__m128i ws[4];
+			for (int i = 0; i < 4; i++)
+			{
+				__m128i x = _mm_sub_epi8(v[i], first);
+				ws[i] = _mm_or_si128(_mm_cmpeq_epi8(v[i], space), _mm_cmpeq_epi8(_mm_min_epu8(x, range), x));
+			}
+			return Mask(ws);
+		}
+
+		__m128i v[4];
+	};
+
+	#endif
+
+#endif
+
+
+	// Returns the offset of the first quote or escape character in the data, or its size if there are none
+	unsigned int FindStringEnd(const char* data, unsigned int size)
+	{
+		unsigned int pos = 0;
+
+	#if defined(CLUTL_JSON_SIMD)
+		for (; pos + BLOCK_SIZE <= size; pos += BLOCK_SIZE)
+		{
+			Block block(data + pos);
+			clcpp::uint64 mask = block.Equals('\"') | block.Equals('\\');
+			if (mask != 0)
+				return pos + FirstBit(mask);
+		}
+	#endif
+
+		while (pos < size && data[pos] != '\"' && data[pos] != '\\')
+			pos++;
+		return pos;
+	}
+
+
+	void SkipWhitespace(clutl::JSONContext& ctx)
+	{
+		const char* data = ctx.PeekChars();
+		unsigned int size = ctx.Remaining();
+		unsigned int pos = 0;
+		unsigned int consumed = 0;
+
+	#if defined(CLUTL_JSON_SIMD)
+		for (; pos + BLOCK_SIZE <= size; pos += BLOCK_SIZE)
+		{
+			// Locate the end of the whitespace run within this block
+			Block block(data + pos);
+			clcpp::uint64 non_whitespace = ~block.Whitespace();
+			unsigned int end = non_whitespace != 0 ? FirstBit(non_whitespace) : BLOCK_SIZE;
+
+			// Update the line count for each newline in the run, for error reporting
+			clcpp::uint64 newlines = block.Equals('\n');
+			if (end < BLOCK_SIZE)
+				newlines &= (1ULL << end) - 1;
+			for (; newlines != 0; newlines &= newlines - 1)
+			{
+				unsigned int newline = pos + FirstBit(newlines);
+				ctx.ConsumeChars(newline - consumed);
+				ctx.IncLine();
+				consumed = newline;
+			}
+
+			if (end < BLOCK_SIZE)
+			{
+				ctx.ConsumeChars(pos + end - consumed);
+				return;
+			}
+		}
+	#endif
+
+		for (; pos < size && iswhitespace(data[pos]); pos++)
+		{
+			if (data[pos] == '\n')
+			{
+				ctx.ConsumeChars(pos - consumed);
+				ctx.IncLine();
+				consumed = pos;
+			}
+		}
+
+		ctx.ConsumeChars(pos - consumed);
+	}
 
 
 	int Lexer32bitHexDigits(clutl::JSONContext& ctx)
@@ -91,22 +305,27 @@ namespace
 		// Start off construction of the string beyond the open quote
 		ctx.ConsumeChar();
 		clutl::JSONToken token(clutl::JSON_TOKEN_STRING, 0);
-		token.val.string = ctx.PeekChars();
 
 		// The common case here is another character as opposed to quotes so
-		// keep looping until that happens
+		// skip straight to the next quote or escape sequence
 		int len = 0;
 		while (true)
 		{
+			unsigned int nb_chars = FindStringEnd(ctx.PeekChars(), ctx.Remaining());
+			ctx.ConsumeChars(nb_chars);
+			token.length += nb_chars;
+
 			if (ctx.ReadOverflows(0))
 				return clutl::JSONToken();
 			char c = ctx.PeekChar();
 
 			switch (c)
 			{
-			// The string terminates with a quote
+			// The string terminates with a quote. Locate the string only once all of it has been
+			// read, as streaming in more input can move it.
 			case '\"':
 				ctx.ConsumeChar();
+				token.val.string = ctx.TokenStart() + 1;
 				return token;
 
 			// Escape sequence
@@ -116,11 +335,6 @@ namespace
 					return clutl::JSONToken();
 				token.length += 1 + len;
 				break;
-
-			// A typical string character
-			default:
-				ctx.ConsumeChar();
-				token.length++;
 			}
 		}
 
@@ -128,12 +342,33 @@ namespace
 	}
 
 
+	bool IsEightDigits(clcpp::uint64 chars)
+	{
+		// Each byte must be in the range 0x30-0x39, which adding 6 keeps below 0x40
+		clcpp::uint64 add = chars + 0x0606060606060606ULL;
+		return ((chars & 0xF0F0F0F0F0F0F0F0ULL) | ((add & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+	}
+
+
+	unsigned int ParseEightDigits(clcpp::uint64 chars)
+	{
+		// Combine adjacent digits into pairs, then quads, then the final 8-digit value
+		chars -= 0x3030303030303030ULL;
+		chars = (chars * 10) + (chars >> 8);
+		chars = (((chars & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+				 (((chars >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+		return (unsigned int)chars;
+	}
+
+
 	//
-	// This will return an integer in the range [-9,223,372,036,854,775,808:9,223,372,036,854,775,807]
+	// Consumes a run of one or more digits, accumulating them onto the end of value. The value
+	// wraps on overflow, which is also recorded in the overflow flag.
 	//
-	bool LexerInteger(clutl::JSONContext& ctx, clcpp::uint64& uintval)
+	bool LexerDigits(clutl::JSONContext& ctx, clcpp::uint64& value, int& nb_digits, bool& overflow)
 	{
 		// Consume the first digit
+		nb_digits = 0;
 		if (ctx.ReadOverflows(0))
 			return false;
 		char c = ctx.PeekChar();
@@ -143,19 +378,305 @@ namespace
 			return false;
 		}
 
-		uintval = 0;
-		do 
+		while (true)
 		{
-			// Consume and accumulate the digit
-			ctx.ConsumeChar();
-			uintval = (uintval * 10) + (c - '0');
+			// Convert 8 digits at a time while they're available, loading in little-endian order
+			// so that the first digit lands in the lowest byte
+			while (ctx.Remaining() >= 8)
+			{
+				const unsigned char* chars = (const unsigned char*)ctx.PeekChars();
+				clcpp::uint64 eight = 0;
+				for (int i = 7; i >= 0; i--)
+					eight = (eight << 8) | chars[i];
+				if (!IsEightDigits(eight))
+					break;
+
+				if (value >= 184467440737ULL)
+					overflow = true;
+				value = value * 100000000 + ParseEightDigits(eight);
+				nb_digits += 8;
+				ctx.ConsumeChars(8);
+			}
 
-			// Peek at the next character and leave if its not a digit
+			// Consume and accumulate the digit
 			if (ctx.ReadOverflows(0))
 				return false;
 			c = ctx.PeekChar();
-		} while (isdigit(c));
+			if (!isdigit(c))
+				break;
+			if (value >= 1844674407370955161ULL)
+				overflow = true;
+			value = (value * 10) + (c - '0');
+			nb_digits++;
+			ctx.ConsumeChar();
+		}
+
+		return true;
+	}
+
+
+	// Exact powers of ten for the fast path of decimal conversion
+	const double g_PowersOfTen[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+
+	// 128-bit truncated approximations of 5^q, normalised so that the top bit is set, from
+	// "Number Parsing at a Gigabyte per Second", Daniel Lemire, 2021
+	const int SMALLEST_POWER_OF_FIVE = -64;
+	const int LARGEST_POWER_OF_FIVE = 64;
+	const clcpp::uint64 g_PowersOfFive[][2] = {
+		{ 0xA87FEA27A539E9A5ULL, 0x3F2398D747B36224ULL },
+		{ 0xD29FE4B18E88640EULL, 0x8EEC7F0D19A03AADULL },
+		{ 0x83A3EEEEF9153E89ULL, 0x1953CF68300424ACULL },
+		{ 0xA48CEAAAB75A8E2BULL, 0x5FA8C3423C052DD7ULL },
+		{ 0xCDB02555653131B6ULL, 0x3792F412CB06794DULL },
+		{ 0x808E17555F3EBF11ULL, 0xE2BBD88BBEE40BD0ULL },
+		{ 0xA0B19D2AB70E6ED6ULL, 0x5B6ACEAEAE9D0EC4ULL },
+		{ 0xC8DE047564D20A8BULL, 0xF245825A5A445275ULL },
+		{ 0xFB158592BE068D2EULL, 0xEED6E2F0F0D56712ULL },
+		{ 0x9CED737BB6C4183DULL, 0x55464DD69685606BULL },
+		{ 0xC428D05AA4751E4CULL, 0xAA97E14C3C26B886ULL },
+		{ 0xF53304714D9265DFULL, 0xD53DD99F4B3066A8ULL },
+		{ 0x993FE2C6D07B7FABULL, 0xE546A8038EFE4029ULL },
+		{ 0xBF8FDB78849A5F96ULL, 0xDE98520472BDD033ULL },
+		{ 0xEF73D256A5C0F77CULL, 0x963E66858F6D4440ULL },
+		{ 0x95A8637627989AADULL, 0xDDE7001379A44AA8ULL },
+		{ 0xBB127C53B17EC159ULL, 0x5560C018580D5D52ULL },
+		{ 0xE9D71B689DDE71AFULL, 0xAAB8F01E6E10B4A6ULL },
+		{ 0x9226712162AB070DULL, 0xCAB3961304CA70E8ULL },
+		{ 0xB6B00D69BB55C8D1ULL, 0x3D607B97C5FD0D22ULL },
+		{ 0xE45C10C42A2B3B05ULL, 0x8CB89A7DB77C506AULL },
+		{ 0x8EB98A7A9A5B04E3ULL, 0x77F3608E92ADB242ULL },
+		{ 0xB267ED1940F1C61CULL, 0x55F038B237591ED3ULL },
+		{ 0xDF01E85F912E37A3ULL, 0x6B6C46DEC52F6688ULL },
+		{ 0x8B61313BBABCE2C6ULL, 0x2323AC4B3B3DA015ULL },
+		{ 0xAE397D8AA96C1B77ULL, 0xABEC975E0A0D081AULL },
+		{ 0xD9C7DCED53C72255ULL, 0x96E7BD358C904A21ULL },
+		{ 0x881CEA14545C7575ULL, 0x7E50D64177DA2E54ULL },
+		{ 0xAA242499697392D2ULL, 0xDDE50BD1D5D0B9E9ULL },
+		{ 0xD4AD2DBFC3D07787ULL, 0x955E4EC64B44E864ULL },
+		{ 0x84EC3C97DA624AB4ULL, 0xBD5AF13BEF0B113EULL },
+		{ 0xA6274BBDD0FADD61ULL, 0xECB1AD8AEACDD58EULL },
+		{ 0xCFB11EAD453994BAULL, 0x67DE18EDA5814AF2ULL },
+		{ 0x81CEB32C4B43FCF4ULL, 0x80EACF948770CED7ULL },
+		{ 0xA2425FF75E14FC31ULL, 0xA1258379A94D028DULL },
+		{ 0xCAD2F7F5359A3B3EULL, 0x096EE45813A04330ULL },
+		{ 0xFD87B5F28300CA0DULL, 0x8BCA9D6E188853FCULL },
+		{ 0x9E74D1B791E07E48ULL, 0x775EA264CF55347EULL },
+		{ 0xC612062576589DDAULL, 0x95364AFE032A819EULL },
+		{ 0xF79687AED3EEC551ULL, 0x3A83DDBD83F52205ULL },
+		{ 0x9ABE14CD44753B52ULL, 0xC4926A9672793543ULL },
+		{ 0xC16D9A0095928A27ULL, 0x75B7053C0F178294ULL },
+		{ 0xF1C90080BAF72CB1ULL, 0x5324C68B12DD6339ULL },
+		{ 0x971DA05074DA7BEEULL, 0xD3F6FC16EBCA5E04ULL },
+		{ 0xBCE5086492111AEAULL, 0x88F4BB1CA6BCF585ULL },
+		{ 0xEC1E4A7DB69561A5ULL, 0x2B31E9E3D06C32E6ULL },
+		{ 0x9392EE8E921D5D07ULL, 0x3AFF322E62439FD0ULL },
+		{ 0xB877AA3236A4B449ULL, 0x09BEFEB9FAD487C3ULL },
+		{ 0xE69594BEC44DE15BULL, 0x4C2EBE687989A9B4ULL },
+		{ 0x901D7CF73AB0ACD9ULL, 0x0F9D37014BF60A11ULL },
+		{ 0xB424DC35095CD80FULL, 0x538484C19EF38C95ULL },
+		{ 0xE12E13424BB40E13ULL, 0x2865A5F206B06FBAULL },
+		{ 0x8CBCCC096F5088CBULL, 0xF93F87B7442E45D4ULL },
+		{ 0xAFEBFF0BCB24AAFEULL, 0xF78F69A51539D749ULL },
+		{ 0xDBE6FECEBDEDD5BEULL, 0xB573440E5A884D1CULL },
+		{ 0x89705F4136B4A597ULL, 0x31680A88F8953031ULL },
+		{ 0xABCC77118461CEFCULL, 0xFDC20D2B36BA7C3EULL },
+		{ 0xD6BF94D5E57A42BCULL, 0x3D32907604691B4DULL },
+		{ 0x8637BD05AF6C69B5ULL, 0xA63F9A49C2C1B110ULL },
+		{ 0xA7C5AC471B478423ULL, 0x0FCF80DC33721D54ULL },
+		{ 0xD1B71758E219652BULL, 0xD3C36113404EA4A9ULL },
+		{ 0x83126E978D4FDF3BULL, 0x645A1CAC083126EAULL },
+		{ 0xA3D70A3D70A3D70AULL, 0x3D70A3D70A3D70A4ULL },
+		{ 0xCCCCCCCCCCCCCCCCULL, 0xCCCCCCCCCCCCCCCDULL },
+		{ 0x8000000000000000ULL, 0x0000000000000000ULL },
+		{ 0xA000000000000000ULL, 0x0000000000000000ULL },
+		{ 0xC800000000000000ULL, 0x0000000000000000ULL },
+		{ 0xFA00000000000000ULL, 0x0000000000000000ULL },
+		{ 0x9C40000000000000ULL, 0x0000000000000000ULL },
+		{ 0xC350000000000000ULL, 0x0000000000000000ULL },
+		{ 0xF424000000000000ULL, 0x0000000000000000ULL },
+		{ 0x9896800000000000ULL, 0x0000000000000000ULL },
+		{ 0xBEBC200000000000ULL, 0x0000000000000000ULL },
+		{ 0xEE6B280000000000ULL, 0x0000000000000000ULL },
+		{ 0x9502F90000000000ULL, 0x0000000000000000ULL },
+		{ 0xBA43B74000000000ULL, 0x0000000000000000ULL },
+		{ 0xE8D4A51000000000ULL, 0x0000000000000000ULL },
+		{ 0x9184E72A00000000ULL, 0x0000000000000000ULL },
+		{ 0xB5E620F480000000ULL, 0x0000000000000000ULL },
+		{ 0xE35FA931A0000000ULL, 0x0000000000000000ULL },
+		{ 0x8E1BC9BF04000000ULL, 0x0000000000000000ULL },
+		{ 0xB1A2BC2EC5000000ULL, 0x0000000000000000ULL },
+		{ 0xDE0B6B3A76400000ULL, 0x0000000000000000ULL },
+		{ 0x8AC7230489E80000ULL, 0x0000000000000000ULL },
+		{ 0xAD78EBC5AC620000ULL, 0x0000000000000000ULL },
+		{ 0xD8D726B7177A8000ULL, 0x0000000000000000ULL },
+		{ 0x878678326EAC9000ULL, 0x0000000000000000ULL },
+		{ 0xA968163F0A57B400ULL, 0x0000000000000000ULL },
+		{ 0xD3C21BCECCEDA100ULL, 0x0000000000000000ULL },
+		{ 0x84595161401484A0ULL, 0x0000000000000000ULL },
+		{ 0xA56FA5B99019A5C8ULL, 0x0000000000000000ULL },
+		{ 0xCECB8F27F4200F3AULL, 0x0000000000000000ULL },
+		{ 0x813F3978F8940984ULL, 0x4000000000000000ULL },
+		{ 0xA18F07D736B90BE5ULL, 0x5000000000000000ULL },
+		{ 0xC9F2C9CD04674EDEULL, 0xA400000000000000ULL },
+		{ 0xFC6F7C4045812296ULL, 0x4D00000000000000ULL },
+		{ 0x9DC5ADA82B70B59DULL, 0xF020000000000000ULL },
+		{ 0xC5371912364CE305ULL, 0x6C28000000000000ULL },
+		{ 0xF684DF56C3E01BC6ULL, 0xC732000000000000ULL },
+		{ 0x9A130B963A6C115CULL, 0x3C7F400000000000ULL },
+		{ 0xC097CE7BC90715B3ULL, 0x4B9F100000000000ULL },
+		{ 0xF0BDC21ABB48DB20ULL, 0x1E86D40000000000ULL },
+		{ 0x96769950B50D88F4ULL, 0x1314448000000000ULL },
+		{ 0xBC143FA4E250EB31ULL, 0x17D955A000000000ULL },
+		{ 0xEB194F8E1AE525FDULL, 0x5DCFAB0800000000ULL },
+		{ 0x92EFD1B8D0CF37BEULL, 0x5AA1CAE500000000ULL },
+		{ 0xB7ABC627050305ADULL, 0xF14A3D9E40000000ULL },
+		{ 0xE596B7B0C643C719ULL, 0x6D9CCD05D0000000ULL },
+		{ 0x8F7E32CE7BEA5C6FULL, 0xE4820023A2000000ULL },
+		{ 0xB35DBF821AE4F38BULL, 0xDDA2802C8A800000ULL },
+		{ 0xE0352F62A19E306EULL, 0xD50B2037AD200000ULL },
+		{ 0x8C213D9DA502DE45ULL, 0x4526F422CC340000ULL },
+		{ 0xAF298D050E4395D6ULL, 0x9670B12B7F410000ULL },
+		{ 0xDAF3F04651D47B4CULL, 0x3C0CDD765F114000ULL },
+		{ 0x88D8762BF324CD0FULL, 0xA5880A69FB6AC800ULL },
+		{ 0xAB0E93B6EFEE0053ULL, 0x8EEA0D047A457A00ULL },
+		{ 0xD5D238A4ABE98068ULL, 0x72A4904598D6D880ULL },
+		{ 0x85A36366EB71F041ULL, 0x47A6DA2B7F864750ULL },
+		{ 0xA70C3C40A64E6C51ULL, 0x999090B65F67D924ULL },
+		{ 0xD0CF4B50CFE20765ULL, 0xFFF4B4E3F741CF6DULL },
+		{ 0x82818F1281ED449FULL, 0xBFF8F10E7A8921A4ULL },
+		{ 0xA321F2D7226895C7ULL, 0xAFF72D52192B6A0DULL },
+		{ 0xCBEA6F8CEB02BB39ULL, 0x9BF4F8A69F764490ULL },
+		{ 0xFEE50B7025C36A08ULL, 0x02F236D04753D5B4ULL },
+		{ 0x9F4F2726179A2245ULL, 0x01D762422C946590ULL },
+		{ 0xC722F0EF9D80AAD6ULL, 0x424D3AD2B7B97EF5ULL },
+		{ 0xF8EBAD2B84E0D58BULL, 0xD2E0898765A7DEB2ULL },
+		{ 0x9B934C3B330C8577ULL, 0x63CC55F49F88EB2FULL },
+		{ 0xC2781F49FFCFA6D5ULL, 0x3CBF6B71C76B25FBULL }
+	};
+
+
+	unsigned int LeadingZeros(clcpp::uint64 value)
+	{
+	#if defined(CLCPP_USING_MSVC)
+		// Split into 32-bit scans so that this also works on 32-bit platforms
+		unsigned long index;
+		if (_BitScanReverse(&index, (unsigned long)(value >> 32)))
+			return 31 - index;
+		_BitScanReverse(&index, (unsigned long)value);
+		return 63 - index;
+	#else
+		return __builtin_clzll(value);
+	#endif
+	}
+
+
+	clcpp::uint64 Multiply128(clcpp::uint64 a, clcpp::uint64 b, clcpp::uint64& hi)
+	{
+	#if defined(__SIZEOF_INT128__)
+		unsigned __int128 product = (unsigned __int128)a * b;
+		hi = (clcpp::uint64)(product >> 64);
+		return (clcpp::uint64)product;
+	#elif defined(CLCPP_USING_MSVC) && defined(_M_X64)
+		return _umul128(a, b, &hi);
+	#else
+		clcpp::uint64 a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+		clcpp::uint64 b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+		clcpp::uint64 p0 = a_lo * b_lo;
+		clcpp::uint64 p1 = a_lo * b_hi;
+		clcpp::uint64 p2 = a_hi * b_lo;
+		clcpp::uint64 mid = (p0 >> 32) + (p1 & 0xFFFFFFFF) + (p2 & 0xFFFFFFFF);
+		hi = a_hi * b_hi + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+		return (mid << 32) | (p0 & 0xFFFFFFFF);
+	#endif
+	}
+
 
+	//
+	// Converts mantissa * 10^exponent to the nearest double, returning false for the rare cases
+	// where this can't be decided quickly and a full conversion is needed
+	//
+	bool ParseDecimal(clcpp::uint64 mantissa, int exponent, bool negative, double& decimal)
+	{
+		if (mantissa == 0)
+		{
+			decimal = negative ? -0.0 : 0.0;
+			return true;
+		}
+
+		// Both the mantissa and the power of ten are exact doubles so a single multiply or divide
+		// rounds correctly (Clinger, 1990)
+		if (exponent >= -22 && exponent <= 22 && mantissa <= (1ULL << 53))
+		{
+			decimal = (double)mantissa;
+			if (exponent < 0)
+				decimal /= g_PowersOfTen[-exponent];
+			else
+				decimal *= g_PowersOfTen[exponent];
+			if (negative)
+				decimal = -decimal;
+			return true;
+		}
+
+		if (exponent < SMALLEST_POWER_OF_FIVE || exponent > LARGEST_POWER_OF_FIVE)
+			return false;
+
+		// Eisel-Lemire: multiply the normalised mantissa by the truncated power of five, widening
+		// to the full 128-bit power when the truncation could affect the result
+		int lz = LeadingZeros(mantissa);
+		mantissa <<= lz;
+		const clcpp::uint64* power = g_PowersOfFive[exponent - SMALLEST_POWER_OF_FIVE];
+		clcpp::uint64 upper;
+		clcpp::uint64 lower = Multiply128(mantissa, power[0], upper);
+		if ((upper & 0x1FF) == 0x1FF && lower + mantissa < lower)
+		{
+			clcpp::uint64 second_hi;
+			clcpp::uint64 second_lo = Multiply128(mantissa, power[1], second_hi);
+			clcpp::uint64 middle = lower + second_hi;
+			if (second_hi > middle)
+				upper++;
+			if ((upper & 0x1FF) == 0x1FF && middle + 1 == 0 && second_lo + mantissa < second_lo)
+				return false;
+			lower = middle;
+		}
+
+		// Keep 54 bits for the 53-bit significand plus a rounding bit
+		clcpp::uint64 upper_bit = upper >> 63;
+		clcpp::uint64 bits = upper >> (upper_bit + 9);
+		lz += int(1 ^ upper_bit);
+		int binary_exponent = (((152170 + 65536) * exponent) >> 16) + 1024 + 63 - lz;
+		if (binary_exponent <= 0 || binary_exponent > 2046)
+			return false;
+
+		// Exactly halfway between two doubles, so round to even rather than up
+		if (exponent >= -4 && exponent <= 23 && lower == 0 && (upper & 0x1FF) == 0 && (bits & 3) == 1)
+		{
+			if ((bits << (upper_bit + 64 - 53 - 2)) == upper)
+				bits &= ~1ULL;
+		}
+
+		bits += bits & 1;
+		bits >>= 1;
+		if (bits >= (1ULL << 53))
+		{
+			bits = 1ULL << 52;
+			binary_exponent++;
+			if (binary_exponent > 2046)
+				return false;
+		}
+
+		bits &= ~(1ULL << 52);
+		bits |= (clcpp::uint64)binary_exponent << 52;
+		bits |= (clcpp::uint64)negative << 63;
+		union {
+			clcpp::uint64 bits;
+			double decimal;
+		} u;
+		u.bits = bits;
+		decimal = u.decimal;
 		return true;
 	}
 
@@ -196,67 +717,12 @@ namespace
 	}
 
 
-	const char* VerifyDigits(clutl::JSONContext& ctx, const char* decimal, const char* end)
-	{
-		while (true)
-		{
-			if (decimal >= end)
-			{
-				ctx.SetError(clutl::JSONError::UNEXPECTED_END_OF_DATA);
-				return 0;
-			}
-
-			if (!isdigit(*decimal))
-				break;
-
-			decimal++;
-		}
-
-		return decimal;
-	}
-
-
-	bool VerifyDecimal(clutl::JSONContext& ctx, const char* decimal, int len)
-	{
-		// Check that there is stuff beyond the .,e,E
-		if (len < 2)
-		{
-			ctx.SetError(clutl::JSONError::UNEXPECTED_END_OF_DATA);
-			return false;
-		}
-
-		const char* end = decimal + len;
-		if (*decimal++ == '.')
-		{
-			// Ensure there are digits trailing the decimal point
-			decimal = VerifyDigits(ctx, decimal, end);
-			if (decimal == 0)
-				return false;
-
-			// Only need to continue if there's an exponent
-			char c = *decimal++;
-			if (c != 'e' && c != 'E')
-				return true;
-		}
-
-		// Skip over any pos/neg qualifiers
-		char c = *decimal;
-		if (c == '-' || c == '+')
-			decimal++;
-
-		// Ensure there are digits trailing the exponent
-		return VerifyDigits(ctx, decimal, end) != 0;
-	}
-
-
 	clutl::JSONToken LexerNumber(clutl::JSONContext& ctx)
 	{
 		// Start off construction of an integer
-		const char* number_start = ctx.PeekChars();
 		clutl::JSONToken token(clutl::JSON_TOKEN_INTEGER, 0);
 
 		// Is this a hex integer?
-		clcpp::uint64 uintval;
 		if (ctx.PeekChar() == '0')
 		{
 			if (ctx.ReadOverflows(1))
@@ -282,33 +748,72 @@ namespace
 			ctx.ConsumeChar();
 		}
 
-		// Parse integer digits
-		if (!LexerInteger(ctx, uintval))
+		// Parse integer digits, accumulating all digits into the mantissa of any decimal
+		clcpp::uint64 mantissa = 0;
+		int nb_digits;
+		bool overflow = false;
+		if (!LexerDigits(ctx, mantissa, nb_digits, overflow))
 			return clutl::JSONToken();
 
 		// Convert to signed integer
 		if (is_negative)
-			token.val.integer = 0ULL - uintval;
+			token.val.integer = 0ULL - mantissa;
 		else
-			token.val.integer = uintval;
+			token.val.integer = mantissa;
 
 		// Is this a decimal?
-		const char* decimal_start = ctx.PeekChars();
-		char c = *decimal_start;
-		if (c == '.' || c == 'e' || c == 'E')
+		char c = ctx.PeekChar();
+		if (c != '.' && c != 'e' && c != 'E')
+			return token;
+
+		int exponent = 0;
+		if (c == '.')
 		{
-			if (!VerifyDecimal(ctx, decimal_start, ctx.Remaining()))
+			// Fractional digits scale the mantissa down
+			ctx.ConsumeChar();
+			if (ctx.ReadOverflows(0))
 				return clutl::JSONToken();
+			if (isdigit(ctx.PeekChar()))
+			{
+				if (!LexerDigits(ctx, mantissa, nb_digits, overflow))
+					return clutl::JSONToken();
+				exponent = -nb_digits;
+			}
+			c = ctx.PeekChar();
+		}
 
-			// Re-evaluate as a decimal using the more expensive strtod function
-			char* number_end;
-			token.type = clutl::JSON_TOKEN_DECIMAL;
-			token.val.decimal = strtod(number_start, &number_end);
+		if (c == 'e' || c == 'E')
+		{
+			// Skip over any pos/neg qualifiers
+			ctx.ConsumeChar();
+			if (ctx.ReadOverflows(0))
+				return clutl::JSONToken();
+			bool exponent_negative = false;
+			c = ctx.PeekChar();
+			if (c == '-' || c == '+')
+			{
+				exponent_negative = c == '-';
+				ctx.ConsumeChar();
+			}
 
-			// Skip over the parsed decimal
-			ctx.ConsumeChars(number_end - decimal_start);
+			// Exponents too large to represent are left for strtod to clamp
+			clcpp::uint64 exponent_value = 0;
+			bool exponent_overflow = false;
+			if (!LexerDigits(ctx, exponent_value, nb_digits, exponent_overflow))
+				return clutl::JSONToken();
+			if (exponent_overflow || exponent_value > 100000)
+				overflow = true;
+			else
+				exponent += exponent_negative ? -int(exponent_value) : int(exponent_value);
 		}
 
+		// Fall back to the more expensive strtod function when the mantissa has more digits than
+		// fit in 64 bits or the value can't be converted quickly. The whole number is still in
+		// memory as the token start is kept in the input window.
+		token.type = clutl::JSON_TOKEN_DECIMAL;
+		if (overflow || !ParseDecimal(mantissa, exponent, is_negative, token.val.decimal))
+			token.val.decimal = strtod(ctx.TokenStart(), 0);
+
 		return token;
 	}
 
@@ -349,7 +854,93 @@ clutl::JSONContext::JSONContext(clutl::ReadBuffer& read_buffer)
 	, m_Line(1)
 	, m_LinePosition(0)
 	, m_StackPosition(0xFFFFFFFF)
+	, m_StackTokenPosition(0)
+	, m_Source(0)
+	, m_Window(0)
+	, m_RetiredWindow(0)
+	, m_WindowCapacity(0)
+	, m_WindowPosition(0)
+	, m_TokenPosition(0)
+{
+}
+
+
+clutl::JSONContext::JSONContext(clutl::IReadSource& source, unsigned int chunk_size)
+	: m_ReadBuffer(m_StreamBuffer)
+	, m_Line(1)
+	, m_LinePosition(0)
+	, m_StackPosition(0xFFFFFFFF)
+	, m_StackTokenPosition(0)
+	, m_Source(&source)
+	, m_Window(0)
+	, m_RetiredWindow(0)
+	, m_WindowCapacity(chunk_size)
+	, m_WindowPosition(0)
+	, m_TokenPosition(0)
+{
+	clcpp::internal::Assert(chunk_size != 0);
+	m_Window = new char[chunk_size];
+	m_StreamBuffer = clutl::ReadBuffer(m_Window, 0);
+}
+
+
+clutl::JSONContext::~JSONContext()
+{
+	delete [] m_Window;
+	delete [] m_RetiredWindow;
+}
+
+
+bool clutl::JSONContext::Fill(unsigned int size)
+{
+	while (m_Source != 0 && m_ReadBuffer.GetBytesRemaining() < size)
+	{
+		// Only input from the start of the current token, or of the token saved with any pushed
+		// state, can still be referred to
+		unsigned int keep_position = m_TokenPosition;
+		if (m_StackPosition != 0xFFFFFFFF && m_StackTokenPosition < keep_position)
+			keep_position = m_StackTokenPosition;
+		unsigned int nb_discard = keep_position - m_WindowPosition;
+		unsigned int nb_keep = m_ReadBuffer.GetTotalBytes() - nb_discard;
+		unsigned int read_position = m_ReadBuffer.GetBytesRead() - nb_discard;
+
+		// Move what's kept to the start of a new window when there's input to discard or no room
+		// left, doubling the window size if it's mostly needed for what's kept
+		if (nb_discard != 0 || nb_keep == m_WindowCapacity)
+		{
+			unsigned int capacity = m_WindowCapacity;
+			if (nb_keep > capacity / 2)
+				capacity *= 2;
+			char* window = new char[capacity];
+			CopyBytes(window, m_Window + nb_discard, nb_keep);
+
+			// The previous token may still reference the old window so keep it until the next token
+			// starts. Any newer windows since then can't be referenced.
+			if (m_RetiredWindow == 0)
+				m_RetiredWindow = m_Window;
+			else
+				delete [] m_Window;
+
+			m_Window = window;
+			m_WindowCapacity = capacity;
+			m_WindowPosition += nb_discard;
+		}
+
+		// Read as much as will fit, with nothing read signalling the end of the input
+		unsigned int nb_read = m_Source->Read(m_Window + nb_keep, m_WindowCapacity - nb_keep);
+		m_StreamBuffer = clutl::ReadBuffer(m_Window, nb_keep + nb_read);
+		m_StreamBuffer.SeekRel(read_position);
+		if (nb_read == 0)
+			m_Source = 0;
+	}
+
+	return m_ReadBuffer.GetBytesRemaining() >= size;
+}
+
+
+unsigned int clutl::JSONContext::Position() const
 {
+	return m_WindowPosition + m_ReadBuffer.GetBytesRead();
 }
 
 unsigned int clutl::JSONContext::ConsumeChars(int size)
@@ -380,7 +971,7 @@ char clutl::JSONContext::PeekChar()
 
 bool clutl::JSONContext::ReadOverflows(int size, clutl::JSONError::Code code)
 {
-	if (m_ReadBuffer.GetBytesRead() + size >= m_ReadBuffer.GetTotalBytes())
+	if (m_ReadBuffer.GetBytesRead() + size >= m_ReadBuffer.GetTotalBytes() && !Fill(size + 1))
 	{
 		SetError(code);
 		return true;
@@ -400,7 +991,7 @@ void clutl::JSONContext::SetError(clutl::JSONError::Code code)
 	if (m_Error.code == clutl::JSONError::NONE)
 	{
 		m_Error.code = code;
-		m_Error.position = m_ReadBuffer.GetBytesRead();
+		m_Error.position = Position();
 		m_Error.line = m_Line;
 		m_Error.column = m_Error.position - m_LinePosition;
 	}
@@ -410,7 +1001,7 @@ void clutl::JSONContext::SetError(clutl::JSONError::Code code)
 void clutl::JSONContext::IncLine()
 {
 	m_Line++;
-	m_LinePosition = m_ReadBuffer.GetBytesRead();
+	m_LinePosition = Position();
 }
 
 
@@ -419,8 +1010,9 @@ void clutl::JSONContext::PushState(const clutl::JSONToken& token)
 	clcpp::internal::Assert(m_StackPosition == 0xFFFFFFFF);
 
 	// Push
-	m_StackPosition = m_ReadBuffer.GetBytesRead();
+	m_StackPosition = Position();
 	m_StackToken = token;
+	m_StackTokenPosition = m_TokenPosition;
 }
 
 
@@ -428,10 +1020,13 @@ void clutl::JSONContext::PopState(clutl::JSONToken& token)
 {
 	clcpp::internal::Assert(m_StackPosition != 0xFFFFFFFF);
 
-	// Restore state
-	int offset = m_ReadBuffer.GetBytesRead() - m_StackPosition;
+	// Restore state, locating any string again in case streaming in input has moved it
+	int offset = Position() - m_StackPosition;
 	m_ReadBuffer.SeekRel(-offset);
 	token = m_StackToken;
+	m_TokenPosition = m_StackTokenPosition;
+	if (token.type == clutl::JSON_TOKEN_STRING)
+		token.val.string = TokenStart() + 1;
 
 	// Pop
 	m_StackPosition = 0xFFFFFFFF;
@@ -439,8 +1034,30 @@ void clutl::JSONContext::PopState(clutl::JSONToken& token)
 }
 
 
+void clutl::JSONContext::BeginToken()
+{
+	delete [] m_RetiredWindow;
+	m_RetiredWindow = 0;
+	MoveTokenStart();
+}
+
+
+void clutl::JSONContext::MoveTokenStart()
+{
+	m_TokenPosition = Position();
+}
+
+
+const char* clutl::JSONContext::TokenStart()
+{
+	return m_ReadBuffer.ReadAt(m_TokenPosition - m_WindowPosition);
+}
+
+
 CLCPP_API clutl::JSONToken clutl::LexerNextToken(clutl::JSONContext& ctx)
 {
+	ctx.BeginToken();
+
 start:
 	// Read the current character and return an empty token at stream end
 	if (ctx.ReadOverflows(0, clutl::JSONError::NONE))
@@ -451,13 +1068,13 @@ start:
 	{
 	// Branch to the start only if it's a whitespace (the least-common case)
 	case '\n':
-		ctx.IncLine();
 	case ' ':
 	case '\t':
 	case '\v':
 	case '\f':
 	case '\r':
-		ctx.ConsumeChar();
+		SkipWhitespace(ctx);
+		ctx.MoveTokenStart();
 		goto start;
 
 	// Structural single character tokens
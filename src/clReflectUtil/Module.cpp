@@ -28,9 +28,12 @@
 	extern "C" void * dlopen(const char * __path, int __mode);
 	extern "C" void * dlsym(void * __handle, const char * __symbol);
 
-	// TODO: check the loading flags when we can get this running, current
-	// flag indicates RTLD_LAZY
-	#define LOADING_FLAGS 0x1
+	// Resolve all symbols on load and keep them local to the module: RTLD_NOW | RTLD_LOCAL
+	#if defined(__APPLE__)
+		#define LOADING_FLAGS (0x2 | 0x4)
+	#else
+		#define LOADING_FLAGS (0x2 | 0x0)
+	#endif
 
 #endif
 
@@ -78,14 +81,14 @@ clutl::Module::Module()
 
 clutl::Module::~Module()
 {
-	if (m_Handle != 0)
-		FreeSharedLibrary(m_Handle);
+	Unload();
 }
 
 
 bool clutl::Module::Load(clcpp::Database* host_db, const char* filename)
 {
 	// Load the DLL
+	clcpp::internal::Assert(m_Handle == 0 && "Module already loaded");
 	m_Handle = LoadSharedLibrary(filename);
 	if (m_Handle == 0)
 		return false;
@@ -104,8 +107,161 @@ bool clutl::Module::Load(clcpp::Database* host_db, const char* filename)
 }
 
 
+void clutl::Module::Unload()
+{
+	if (m_Handle != 0)
+		FreeSharedLibrary(m_Handle);
+	m_Handle = 0;
+	m_HostReflectionDB = 0;
+	m_ReflectionDB = 0;
+}
+
+
 void* clutl::Module::GetFunction(const char* name) const
 {
 	clcpp::internal::Assert(m_Handle != 0);
 	return GetSharedLibraryFunction(m_Handle, name);
 }
+
+
+struct clutl::ModuleRegistry::HashEntry
+{
+	HashEntry() : hash(0), type(0) { }
+	unsigned int hash;
+	const clcpp::Type* type;
+};
+
+
+clutl::ModuleRegistry::ModuleRegistry()
+	: m_MaxNbTypes(1024)
+	, m_NbTypes(0)
+	, m_NbOccupiedEntries(0)
+	, m_Types(0)
+{
+	m_Types = new HashEntry[m_MaxNbTypes];
+}
+
+
+clutl::ModuleRegistry::~ModuleRegistry()
+{
+	delete [] m_Types;
+}
+
+
+void clutl::ModuleRegistry::AddDatabase(const clcpp::Database* db)
+{
+	unsigned int nb_types;
+	const clcpp::Type** types = db->GetTypes(nb_types);
+	for (unsigned int i = 0; i < nb_types; i++)
+		AddHashEntry(types[i]);
+}
+
+
+void clutl::ModuleRegistry::RemoveDatabase(const clcpp::Database* db)
+{
+	unsigned int nb_types;
+	const clcpp::Type** types = db->GetTypes(nb_types);
+	for (unsigned int i = 0; i < nb_types; i++)
+		RemoveHashEntry(types[i]);
+}
+
+
+void clutl::ModuleRegistry::AddModule(const Module& module)
+{
+	if (const clcpp::Database* db = module.GetReflectionDB())
+		AddDatabase(db);
+}
+
+
+void clutl::ModuleRegistry::RemoveModule(const Module& module)
+{
+	if (const clcpp::Database* db = module.GetReflectionDB())
+		RemoveDatabase(db);
+}
+
+
+const clcpp::Type* clutl::ModuleRegistry::GetType(unsigned int hash) const
+{
+	// Linear probe from the natural hash location for a matching hash, skipping dummy entries
+	const unsigned int index_mask = m_MaxNbTypes - 1;
+	unsigned int index = hash & index_mask;
+	while (m_Types[index].hash)
+	{
+		if (m_Types[index].hash == hash && m_Types[index].type != 0)
+			return m_Types[index].type;
+		index = (index + 1) & index_mask;
+	}
+	return 0;
+}
+
+
+void clutl::ModuleRegistry::AddHashEntry(const clcpp::Type* type)
+{
+	// Linear probe from the natural hash location for a free slot, reusing any dummy slots
+	unsigned int hash = type->name.hash;
+	const unsigned int index_mask = m_MaxNbTypes - 1;
+	unsigned int index = hash & index_mask;
+	while (m_Types[index].hash && m_Types[index].type != 0)
+		index = (index + 1) & index_mask;
+
+	// Only count newly occupied slots
+	HashEntry& he = m_Types[index];
+	if (he.hash == 0)
+		m_NbOccupiedEntries++;
+	he.hash = hash;
+	he.type = type;
+	m_NbTypes++;
+
+	// Resize when load factor is greater than 2/3 or flush dummy entries so that there is always
+	// at least one empty slot for the GetType loop to terminate on
+	if (m_NbTypes > (m_MaxNbTypes * 2) / 3)
+		Resize(true);
+	else if (m_NbOccupiedEntries > (m_MaxNbTypes * 2) / 3)
+		Resize(false);
+}
+
+
+void clutl::ModuleRegistry::RemoveHashEntry(const clcpp::Type* type)
+{
+	// Linear probe from the natural hash location for the entry pointing to this type
+	unsigned int hash = type->name.hash;
+	const unsigned int index_mask = m_MaxNbTypes - 1;
+	unsigned int index = hash & index_mask;
+	while (m_Types[index].hash)
+	{
+		// Leave the hash key in-place, marking the entry as a dummy entry
+		HashEntry& he = m_Types[index];
+		if (he.type == type)
+		{
+			he.type = 0;
+			m_NbTypes--;
+			return;
+		}
+		index = (index + 1) & index_mask;
+	}
+}
+
+
+void clutl::ModuleRegistry::Resize(bool increase)
+{
+	// Backup existing table
+	unsigned int old_max_nb_types = m_MaxNbTypes;
+	HashEntry* old_types = m_Types;
+
+	// Either make the table bigger or leave it the same size to flush all dummy entries
+	if (increase)
+		m_MaxNbTypes *= 2;
+	m_Types = new HashEntry[m_MaxNbTypes];
+
+	// Reinsert all types into the new hash table
+	m_NbTypes = 0;
+	m_NbOccupiedEntries = 0;
+	for (unsigned int i = 0; i < old_max_nb_types; i++)
+	{
+		HashEntry& he = old_types[i];
+		if (he.type != 0)
+			AddHashEntry(he.type);
+	}
+
+	delete [] old_types;
+}
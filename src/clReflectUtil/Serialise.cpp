@@ -8,6 +8,7 @@
 // ===============================================================================
 //
 
+#include <clcpp/FunctionCall.h>
 #include <clutl/Serialise.h>
 
 // Standard C library function, copy bytes
@@ -31,6 +32,12 @@ clutl::WriteBuffer::WriteBuffer(unsigned int initial_capacity)
     m_dataWrite = m_data;
 }
 
+clutl::WriteBuffer::WriteBuffer(IWriteSink* sink, unsigned int capacity)
+    : WriteBuffer(capacity)
+{
+    m_sink = sink;
+}
+
 clutl::WriteBuffer::~WriteBuffer()
 {
     delete[] m_data;
@@ -41,8 +48,31 @@ void clutl::WriteBuffer::Reset()
     m_dataWrite = m_data;
 }
 
+bool clutl::WriteBuffer::Flush()
+{
+    if (m_sink == nullptr)
+    {
+        return false;
+    }
+
+    // Stop writing to the sink after the first failure, discarding everything after it
+    if (!m_sinkFailed && m_dataWrite != m_data)
+    {
+        m_sinkFailed = !m_sink->Write(m_data, m_dataWrite - m_data);
+    }
+
+    m_dataWrite = m_data;
+    return !m_sinkFailed;
+}
+
 void* clutl::WriteBuffer::Alloc(unsigned int length)
 {
+    // Make room by emptying the buffer into any sink before growing it
+    if (m_sink != nullptr && m_dataWrite + length > m_dataEnd)
+    {
+        Flush();
+    }
+
     // TODO: On platforms that support virtual memory, copy can be eliminated
     if (m_dataWrite + length > m_dataEnd)
     {
@@ -76,6 +106,16 @@ void* clutl::WriteBuffer::Alloc(unsigned int length)
 
 void clutl::WriteBuffer::Write(const void* data, unsigned int length)
 {
+    // Pass data that won't fit in a sink's buffer straight on after what's already there
+    if (m_sink != nullptr && length > static_cast<unsigned int>(m_dataEnd - m_data))
+    {
+        if (Flush())
+        {
+            m_sinkFailed = !m_sink->Write(data, length);
+        }
+        return;
+    }
+
     // Allocate enough space for the data and copy it
     void* data_write = Alloc(length);
     memcpy(data_write, data, length);
@@ -139,3 +179,38 @@ void clutl::ReadBuffer::SeekRel(int offset)
     clcpp::internal::Assert(m_dataRead + offset <= m_dataEnd && "Seek overflow");
     m_dataRead += offset;
 }
+
+clutl::ContainerKey::ContainerKey(const clcpp::Type* type)
+    : m_Destructor(nullptr)
+{
+    clcpp::internal::Assert(type->size <= sizeof(m_Data));
+
+    const clcpp::Function* constructor = nullptr;
+    if (type->kind == clcpp::Primitive::KIND_CLASS)
+    {
+        constructor = type->AsClass()->constructor;
+        m_Destructor = type->AsClass()->destructor;
+    }
+    else if (type->kind == clcpp::Primitive::KIND_TEMPLATE_TYPE)
+    {
+        constructor = type->AsTemplateType()->constructor;
+        m_Destructor = type->AsTemplateType()->destructor;
+    }
+
+    if (constructor != nullptr)
+    {
+        clcpp::CallFunction(constructor, (void*)m_Data);
+    }
+    else
+    {
+        m_Destructor = nullptr;
+    }
+}
+
+clutl::ContainerKey::~ContainerKey()
+{
+    if (m_Destructor != nullptr)
+    {
+        clcpp::CallFunction(m_Destructor, (void*)m_Data);
+    }
+}
@@ -71,6 +71,9 @@ void clutl::ParameterObjectCache::Init(const clcpp::Function* function)
 {
     DeleteObjects();
 
+    // Parameters are stored with the functions section, which may not have been loaded yet
+    clcpp::RequireSection(function, clcpp::Database::SECTION_FUNCTIONS);
+
     // Calculate the total space occupied by parameters
     unsigned int total_param_size = 0;
     for (unsigned int i = 0; i < function->parameters.size; i++)
@@ -285,6 +288,7 @@ static bool CallFunction_x86_32_msvc(const clcpp::Function* function, const clut
 
 CLCPP_API bool clutl::CallFunction_x86_32_msvc_cdecl(const clcpp::Function* function, const ParameterData& parameters)
 {
+    clcpp::RequireSection(function, clcpp::Database::SECTION_FUNCTIONS);
     unsigned int nb_params = function->parameters.size;
     if (nb_params != parameters.GetNbParameters())
         return false;
@@ -294,6 +298,7 @@ CLCPP_API bool clutl::CallFunction_x86_32_msvc_cdecl(const clcpp::Function* func
 
 CLCPP_API bool clutl::CallFunction_x86_32_msvc_thiscall(const clcpp::Function* function, const clutl::ParameterData& parameters)
 {
+    clcpp::RequireSection(function, clcpp::Database::SECTION_FUNCTIONS);
     unsigned int nb_params = function->parameters.size;
     if (nb_params != parameters.GetNbParameters())
         return false;
@@ -27,6 +27,8 @@ extern "C" int _snprintf(char* dest, unsigned int n, const char* fmt, ...);
 #else
 extern "C" int snprintf(char* dest, unsigned int n, const char* fmt, ...);
 #endif
+extern "C" double strtod(const char* s00, char** se);
+extern "C" long strtol(const char* s, char** se, int base);
 
 static void SetupTypeDispatchLUT();
 
@@ -112,9 +114,9 @@ namespace
         {
             const clcpp::Enum* enum_type = type->AsEnum();
 
+            clcpp::RequireSection(enum_type, clcpp::Database::SECTION_ATTRIBUTES);
             // Is the enum a series of flags?
-            thread_local static unsigned int hash = clcpp::internal::HashNameString("flags");
-            bool are_flags = clcpp::FindPrimitive(enum_type->attributes, hash) != nullptr;
+            bool are_flags = clcpp::FindPrimitive(enum_type->attributes, "flags"_clhash) != nullptr;
             if (are_flags)
             {
                 int pos = 0;
@@ -241,12 +243,45 @@ namespace
     {
         int count = 0;
 
+        // Parse straight into contiguous blocks of values when a container of fixed size can hand them
+        // out, asking for the values the writer was initialised with. Containers that grow only reserve
+        // their count and have values added as they're parsed, so that none are left over if the array
+        // is shorter than its count.
+        clcpp::ContainerSpan span;
+        bool contiguous = writer != nullptr && !writer->CanGrow() && writer->AddEmptyRange(writer->m_Count, span);
+        unsigned int nb_added = span.count;
+        char* value_data = static_cast<char*>(span.data);
+        char* value_end = value_data + span.count * span.stride;
+
         while (true)
         {
             count++;
 
+            // Move onto the next block when the current one is full
+            if (contiguous && value_data == value_end && nb_added < writer->m_Count &&
+                writer->AddEmptyRange(writer->m_Count - nb_added, span))
+            {
+                nb_added += span.count;
+                value_data = static_cast<char*>(span.data);
+                value_end = value_data + span.count * span.stride;
+            }
+
             // Expect a value first
-            if (writer != nullptr)
+            if (contiguous)
+            {
+                // Values beyond the end of the storage are parsed and discarded
+                if (value_data != value_end)
+                {
+                    ParserValue(ctx, t, value_data, type, op, nullptr, transient_flags);
+                    value_data += span.stride;
+                }
+                else
+                {
+                    ParserValue(ctx, t, nullptr, nullptr, op, nullptr, transient_flags);
+                }
+            }
+            // Values past the count a fixed container was initialised with are discarded
+            else if (writer != nullptr && (count <= static_cast<int>(writer->m_Count) || writer->CanGrow()))
             {
                 ParserValue(ctx, t, static_cast<char*>(writer->AddEmpty()), type, op, nullptr, transient_flags);
             }
@@ -266,6 +301,65 @@ namespace
         return count;
     }
 
+    bool PeekCountHint(clutl::JSONContext& ctx, const clutl::JSONToken& t)
+    {
+        // Arrays can open with a {"$n":count} element; look past the opening brace for the
+        // member name without lexing anything, so that it can be parsed as a normal object
+        // if it isn't there. Checking for overflow streams in any input needed.
+        if (t.type != clutl::JSON_TOKEN_LBRACE)
+        {
+            return false;
+        }
+
+        unsigned int pos = 0;
+        while (!ctx.ReadOverflows(pos, clutl::JSONError::NONE))
+        {
+            char c = ctx.PeekChars()[pos];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+            {
+                break;
+            }
+            pos++;
+        }
+
+        if (ctx.ReadOverflows(pos + 3, clutl::JSONError::NONE))
+        {
+            return false;
+        }
+
+        const char* chars = ctx.PeekChars() + pos;
+        return chars[0] == '"' && chars[1] == '$' && chars[2] == 'n' && chars[3] == '"';
+    }
+
+    int ParserCountHint(clutl::JSONContext& ctx, clutl::JSONToken& t)
+    {
+        if (!PeekCountHint(ctx, t))
+        {
+            return -1;
+        }
+
+        Expect(ctx, t, clutl::JSON_TOKEN_LBRACE);
+        Expect(ctx, t, clutl::JSON_TOKEN_STRING);
+        Expect(ctx, t, clutl::JSON_TOKEN_COLON);
+        clutl::JSONToken count = Expect(ctx, t, clutl::JSON_TOKEN_INTEGER);
+        Expect(ctx, t, clutl::JSON_TOKEN_RBRACE);
+
+        // Step onto the first value, if there is one
+        if (t.type == clutl::JSON_TOKEN_COMMA)
+        {
+            t = LexerNextToken(ctx);
+        }
+
+        // The count only sizes the container so anything that doesn't fit the iterator is ignored,
+        // leaving the container to grow or be counted with a pre-pass
+        if (!count.IsValid() || count.val.integer < 0 || count.val.integer > 0x7FFFFFFF)
+        {
+            return -1;
+        }
+
+        return static_cast<int>(count.val.integer);
+    }
+
     void ParserArray(clutl::JSONContext& ctx, clutl::JSONToken& t, char* object, const clcpp::Type* type,
                      const clcpp::Field* field, unsigned int transient_flags)
     {
@@ -281,10 +375,6 @@ namespace
             return;
         }
 
-        // TODO: Save a field specifying container size. This makes hand-authored JSON a little
-        //       trickier but massively speeds up the general case of game read/written JSON.
-        //       Could make a fallback case for when no container size is specified.
-
         clcpp::WriteIterator writer;
         if (field != nullptr && field->ci != nullptr)
         {
@@ -294,14 +384,36 @@ namespace
 
         else if (type != nullptr && type->ci != nullptr)
         {
-            // Do a pre-pass on the array to count the number of elements
-            // Really not very efficient for big collections of large objects
-            ctx.PushState(t);
-            int array_count = ParserElements(ctx, t, nullptr, nullptr, clcpp::Qualifier::VALUE, transient_flags);
-            ctx.PopState(t);
+            // Template types are dynamic container iterators, sized by any count saved with the array
+            // or grown as values are parsed if there is none
+            int array_count = ParserCountHint(ctx, t);
 
-            // Template types are dynamic container iterators
+            // Every value takes at least one character and a comma, so a count that wouldn't fit in the
+            // input left in memory can't be trusted to allocate with. Containers that grow are then
+            // initialised empty and those that can't are counted with a pre-pass.
+            int max_count = static_cast<int>((ctx.Remaining() + 1) / 2);
+            if (array_count > max_count)
+            {
+                array_count = -1;
+            }
             writer.Initialise(type->AsTemplateType(), object, array_count);
+
+            // An array with no values left after its count
+            if (t.type == clutl::JSON_TOKEN_RBRACKET)
+            {
+                t = LexerNextToken(ctx);
+                return;
+            }
+
+            if (!writer.IsInitialised())
+            {
+                // The container can't grow so do a pre-pass on the array to count the number of elements
+                // Really not very efficient for big collections of large objects
+                ctx.PushState(t);
+                array_count = ParserElements(ctx, t, nullptr, nullptr, clcpp::Qualifier::VALUE, transient_flags);
+                ctx.PopState(t);
+                writer.Initialise(type->AsTemplateType(), object, array_count);
+            }
         }
 
         if (writer.IsInitialised())
@@ -337,9 +449,9 @@ namespace
             // Does this class have a custom load function?
             if ((class_type->flag_attributes & attrFlag_CustomLoad) != 0)
             {
+                clcpp::RequireSection(class_type, clcpp::Database::SECTION_ATTRIBUTES);
                 // Look it up
-                thread_local static unsigned int hash = clcpp::internal::HashNameString("load_json");
-                if (const clcpp::Attribute* attr = clcpp::FindPrimitive(class_type->attributes, hash))
+                if (const clcpp::Attribute* attr = clcpp::FindPrimitive(class_type->attributes, "load_json"_clhash))
                 {
                     const clcpp::PrimitiveAttribute* name_attr = attr->AsPrimitiveAttribute();
 
@@ -390,31 +502,6 @@ namespace
         }
     }
 
-    const clcpp::Field* FindFieldsRecursive(const clcpp::Type* type, unsigned int hash)
-    {
-        // Check fields if this is a class
-        const clcpp::Field* field = nullptr;
-        if (type->kind == clcpp::Primitive::KIND_CLASS)
-        {
-            field = clcpp::FindPrimitive(type->AsClass()->fields, hash);
-        }
-
-        if (field == nullptr)
-        {
-            // Search up through the inheritance hierarchy
-            for (unsigned int i = 0; i < type->base_types.size; i++)
-            {
-                field = FindFieldsRecursive(type->base_types[i], hash);
-                if (field != nullptr)
-                {
-                    break;
-                }
-            }
-        }
-
-        return field;
-    }
-
     void ParserPair(clutl::JSONContext& ctx, clutl::JSONToken& t, char*& object, const clcpp::Type*& type,
                     unsigned int transient_flags)
     {
@@ -433,7 +520,7 @@ namespace
             const clcpp::Class* class_type = type->AsClass();
             unsigned int field_hash = clcpp::internal::HashData(name.val.string, name.length);
 
-            field = FindFieldsRecursive(class_type, field_hash);
+            field = clcpp::FindPrimitive(class_type->all_fields, field_hash);
 
             // Don't load values for transient fields
             if (field != nullptr && (field->flag_attributes & transient_flags) != 0)
@@ -482,9 +569,9 @@ namespace
         while (t.IsValid() && t.type != clutl::JSON_TOKEN_RBRACE)
         {
             // Parse the key, storing the value on the stack
-            char key_data[128];
-            clcpp::internal::Assert(writer.m_KeyType->size < sizeof(key_data));
-            ParserValue(ctx, t, key_data, writer.m_KeyType, clcpp::Qualifier::VALUE, nullptr, transient_flags);
+            clutl::ContainerKey key(writer.m_KeyType);
+            ParserValue(ctx, t, static_cast<char*>(key.GetData()), writer.m_KeyType, clcpp::Qualifier::VALUE, nullptr,
+                        transient_flags);
 
             // Key/value separator
             if (!Expect(ctx, t, clutl::JSON_TOKEN_COLON).IsValid())
@@ -493,7 +580,7 @@ namespace
             }
 
             // Allocate space for new data and parse it
-            void* value_data = writer.AddEmpty(key_data);
+            void* value_data = writer.AddEmpty(key.GetData());
             ParserObject(ctx, t, static_cast<char*>(value_data), writer.m_ValueType, transient_flags);
             Expect(ctx, t, clutl::JSON_TOKEN_RBRACE);
 
@@ -536,8 +623,8 @@ namespace
             // Run any attached post-load functions
             if ((class_type->flag_attributes & attrFlag_PostLoad) != 0)
             {
-                thread_local static unsigned int hash = clcpp::internal::HashNameString("post_load");
-                if (const clcpp::Attribute* attr = clcpp::FindPrimitive(class_type->attributes, hash))
+                clcpp::RequireSection(class_type, clcpp::Database::SECTION_ATTRIBUTES);
+                if (const clcpp::Attribute* attr = clcpp::FindPrimitive(class_type->attributes, "post_load"_clhash))
                 {
                     const clcpp::PrimitiveAttribute* name_attr = attr->AsPrimitiveAttribute();
                     if (name_attr->primitive != nullptr)
@@ -559,6 +646,16 @@ CLCPP_API clutl::JSONError clutl::LoadJSON(ReadBuffer& in, void* object, const c
     return ctx.GetError();
 }
 
+CLCPP_API clutl::JSONError clutl::LoadJSON(IReadSource& source, void* object, const clcpp::Type* type,
+                                           unsigned int transient_flags, unsigned int chunk_size)
+{
+    SetupTypeDispatchLUT();
+    clutl::JSONContext ctx(source, chunk_size);
+    clutl::JSONToken t = LexerNextToken(ctx);
+    ParserObject(ctx, t, static_cast<char*>(object), type, transient_flags);
+    return ctx.GetError();
+}
+
 CLCPP_API clutl::JSONError clutl::LoadJSON(clutl::JSONContext& ctx, void* object, const clcpp::Field* field,
                                            unsigned int transient_flags)
 {
@@ -591,61 +688,65 @@ namespace
         out.WriteChar('\"');
     }
 
-    void SaveInteger(clutl::WriteBuffer& out, clcpp::int64 integer)
-    {
-        // Enough to store a 64-bit int
-        static const int MAX_SZ = 20;
-        char text[MAX_SZ];
-
-        // Null terminate and start at the end
-        text[MAX_SZ - 1] = 0;
-        char* end = text + MAX_SZ - 1;
-        char* tptr = end;
+    // All two-digit decimal numbers, for converting integers two digits at a time
+    const char g_DigitPairs[] =
+        "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+        "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
 
-        // Get the absolute and record if the value is negative
-        bool negative = false;
-        if (integer < 0)
+    char* WriteDigits(char* end, clcpp::uint64 integer)
+    {
+        // Write backwards from the end of the buffer, two digits at a time
+        while (integer >= 100)
         {
-            negative = true;
-            integer = -integer;
+            clcpp::uint64 next_integer = integer / 100;
+            const char* pair = g_DigitPairs + (integer - next_integer * 100) * 2;
+            *--end = pair[1];
+            *--end = pair[0];
+            integer = next_integer;
         }
 
-        // Loop through the value with radix 10
-        do
+        if (integer >= 10)
         {
-            clcpp::int64 next_integer = integer / 10;
-            *--tptr = char('0' + (integer - next_integer * 10));
-            integer = next_integer;
-        } while (integer != 0);
-
-        // Add negative prefix
-        if (negative)
+            const char* pair = g_DigitPairs + integer * 2;
+            *--end = pair[1];
+            *--end = pair[0];
+        }
+        else
         {
-            *--tptr = '-';
+            *--end = char('0' + integer);
         }
 
-        out.Write(tptr, end - tptr);
+        return end;
     }
 
-    void SaveUnsignedInteger(clutl::WriteBuffer& out, clcpp::uint64 integer)
+    void SaveInteger(clutl::WriteBuffer& out, clcpp::int64 integer)
     {
-        // Enough to store a 64-bit int + null
-        static const int MAX_SZ = 21;
+        // Enough to store a 64-bit int and its sign
+        static const int MAX_SZ = 20;
         char text[MAX_SZ];
+        char* end = text + MAX_SZ;
 
-        // Null terminate and start at the end
-        text[MAX_SZ - 1] = 0;
-        char* end = text + MAX_SZ - 1;
-        char* tptr = end;
-
-        // Loop through the value with radix 10
-        do
+        // Negate as unsigned so that the most negative value doesn't overflow
+        if (integer < 0)
         {
-            clcpp::uint64 next_integer = integer / 10;
-            *--tptr = char('0' + (integer - next_integer * 10));
-            integer = next_integer;
-        } while (integer != 0);
+            char* tptr = WriteDigits(end, 0ULL - static_cast<clcpp::uint64>(integer));
+            *--tptr = '-';
+            out.Write(tptr, end - tptr);
+        }
+        else
+        {
+            char* tptr = WriteDigits(end, integer);
+            out.Write(tptr, end - tptr);
+        }
+    }
 
+    void SaveUnsignedInteger(clutl::WriteBuffer& out, clcpp::uint64 integer)
+    {
+        // Enough to store a 64-bit int
+        static const int MAX_SZ = 20;
+        char text[MAX_SZ];
+        char* end = text + MAX_SZ;
+        char* tptr = WriteDigits(end, integer);
         out.Write(tptr, end - tptr);
     }
 
@@ -690,20 +791,432 @@ namespace
         SaveHexInteger(out, *reinterpret_cast<const TYPE*>(object));
     }
 
-    void SaveDecimal(clutl::WriteBuffer& out, double decimal, unsigned int flags)
+    // ----------------------------------------------------------------------------------------------------
+    // Shortest decimal representation of floating point numbers that reads back as the same value, using
+    // the Grisu3 algorithm from "Printing Floating-Point Numbers Quickly and Accurately with Integers",
+    // Florian Loitsch, 2010. Grisu3 detects the rare values (around 0.5%) it can't be sure of and those
+    // fall back to printf.
+    // ----------------------------------------------------------------------------------------------------
+
+    // A floating point number f * 2^e with a 64-bit significand
+    struct DiyFp
+    {
+        DiyFp() = default;
+        DiyFp(clcpp::uint64 f, int e)
+            : f(f)
+            , e(e)
+        {
+        }
+
+        clcpp::uint64 f = 0;
+        int e = 0;
+    };
+
+    DiyFp Multiply(const DiyFp& x, const DiyFp& y)
+    {
+        // Keep the rounded upper 64 bits of the 128-bit product
+        clcpp::uint64 x_lo = x.f & 0xFFFFFFFF;
+        clcpp::uint64 x_hi = x.f >> 32;
+        clcpp::uint64 y_lo = y.f & 0xFFFFFFFF;
+        clcpp::uint64 y_hi = y.f >> 32;
+        clcpp::uint64 p0 = x_lo * y_lo;
+        clcpp::uint64 p1 = x_lo * y_hi;
+        clcpp::uint64 p2 = x_hi * y_lo;
+        clcpp::uint64 p3 = x_hi * y_hi;
+        clcpp::uint64 mid = (p0 >> 32) + (p1 & 0xFFFFFFFF) + (p2 & 0xFFFFFFFF) + (1ULL << 31);
+        return DiyFp(p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32), x.e + y.e + 64);
+    }
+
+    DiyFp Normalise(DiyFp x)
+    {
+        while ((x.f >> 63) == 0)
+        {
+            x.f <<= 1;
+            x.e--;
+        }
+        return x;
+    }
+
+    // Layout of the supported IEEE-754 formats
+    template <typename TYPE>
+    struct FloatTraits;
+    template <>
+    struct FloatTraits<double>
+    {
+        using Bits = clcpp::uint64;
+        static const int PRECISION = 53;
+        static const int BIAS = 1075;
+    };
+    template <>
+    struct FloatTraits<float>
+    {
+        using Bits = unsigned int;
+        static const int PRECISION = 24;
+        static const int BIAS = 150;
+    };
+
+    template <typename TYPE>
+    typename FloatTraits<TYPE>::Bits GetBits(TYPE value)
+    {
+        union {
+            TYPE value;
+            typename FloatTraits<TYPE>::Bits bits;
+        } u;
+        u.value = value;
+        return u.bits;
+    }
+
+    template <typename TYPE>
+    void ComputeBoundaries(TYPE value, DiyFp& w, DiyFp& minus, DiyFp& plus)
+    {
+        // Split the positive, finite value into its significand and exponent
+        using Traits = FloatTraits<TYPE>;
+        const clcpp::uint64 hidden_bit = 1ULL << (Traits::PRECISION - 1);
+        clcpp::uint64 bits = GetBits(value);
+        int exponent = static_cast<int>(bits >> (Traits::PRECISION - 1));
+        clcpp::uint64 fraction = bits & (hidden_bit - 1);
+        DiyFp v = exponent == 0 ? DiyFp(fraction, 1 - Traits::BIAS) : DiyFp(fraction + hidden_bit, exponent - Traits::BIAS);
+
+        // Any decimal between the midpoints with the neighbouring values reads back as this value. The lower
+        // neighbour is closer when the significand is a power of two.
+        plus = Normalise(DiyFp(2 * v.f + 1, v.e - 1));
+        minus = fraction == 0 && exponent > 1 ? DiyFp(4 * v.f - 1, v.e - 2) : DiyFp(2 * v.f - 1, v.e - 1);
+        minus.f <<= minus.e - plus.e;
+        minus.e = plus.e;
+        w = Normalise(v);
+    }
+
+    // Cached powers of ten f * 2^e ~= 10^k, for every 8th k
+    struct CachedPower
+    {
+        clcpp::uint64 f;
+        int e;
+        int k;
+    };
+    const CachedPower g_CachedPowers[] = {
+        { 0xAB70FE17C79AC6CA, -1060, -300 },
+        { 0xFF77B1FCBEBCDC4F, -1034, -292 },
+        { 0xBE5691EF416BD60C, -1007, -284 },
+        { 0x8DD01FAD907FFC3C, -980, -276 },
+        { 0xD3515C2831559A83, -954, -268 },
+        { 0x9D71AC8FADA6C9B5, -927, -260 },
+        { 0xEA9C227723EE8BCB, -901, -252 },
+        { 0xAECC49914078536D, -874, -244 },
+        { 0x823C12795DB6CE57, -847, -236 },
+        { 0xC21094364DFB5637, -821, -228 },
+        { 0x9096EA6F3848984F, -794, -220 },
+        { 0xD77485CB25823AC7, -768, -212 },
+        { 0xA086CFCD97BF97F4, -741, -204 },
+        { 0xEF340A98172AACE5, -715, -196 },
+        { 0xB23867FB2A35B28E, -688, -188 },
+        { 0x84C8D4DFD2C63F3B, -661, -180 },
+        { 0xC5DD44271AD3CDBA, -635, -172 },
+        { 0x936B9FCEBB25C996, -608, -164 },
+        { 0xDBAC6C247D62A584, -582, -156 },
+        { 0xA3AB66580D5FDAF6, -555, -148 },
+        { 0xF3E2F893DEC3F126, -529, -140 },
+        { 0xB5B5ADA8AAFF80B8, -502, -132 },
+        { 0x87625F056C7C4A8B, -475, -124 },
+        { 0xC9BCFF6034C13053, -449, -116 },
+        { 0x964E858C91BA2655, -422, -108 },
+        { 0xDFF9772470297EBD, -396, -100 },
+        { 0xA6DFBD9FB8E5B88F, -369, -92 },
+        { 0xF8A95FCF88747D94, -343, -84 },
+        { 0xB94470938FA89BCF, -316, -76 },
+        { 0x8A08F0F8BF0F156B, -289, -68 },
+        { 0xCDB02555653131B6, -263, -60 },
+        { 0x993FE2C6D07B7FAC, -236, -52 },
+        { 0xE45C10C42A2B3B06, -210, -44 },
+        { 0xAA242499697392D3, -183, -36 },
+        { 0xFD87B5F28300CA0E, -157, -28 },
+        { 0xBCE5086492111AEB, -130, -20 },
+        { 0x8CBCCC096F5088CC, -103, -12 },
+        { 0xD1B71758E219652C, -77, -4 },
+        { 0x9C40000000000000, -50, 4 },
+        { 0xE8D4A51000000000, -24, 12 },
+        { 0xAD78EBC5AC620000, 3, 20 },
+        { 0x813F3978F8940984, 30, 28 },
+        { 0xC097CE7BC90715B3, 56, 36 },
+        { 0x8F7E32CE7BEA5C70, 83, 44 },
+        { 0xD5D238A4ABE98068, 109, 52 },
+        { 0x9F4F2726179A2245, 136, 60 },
+        { 0xED63A231D4C4FB27, 162, 68 },
+        { 0xB0DE65388CC8ADA8, 189, 76 },
+        { 0x83C7088E1AAB65DB, 216, 84 },
+        { 0xC45D1DF942711D9A, 242, 92 },
+        { 0x924D692CA61BE758, 269, 100 },
+        { 0xDA01EE641A708DEA, 295, 108 },
+        { 0xA26DA3999AEF774A, 322, 116 },
+        { 0xF209787BB47D6B85, 348, 124 },
+        { 0xB454E4A179DD1877, 375, 132 },
+        { 0x865B86925B9BC5C2, 402, 140 },
+        { 0xC83553C5C8965D3D, 428, 148 },
+        { 0x952AB45CFA97A0B3, 455, 156 },
+        { 0xDE469FBD99A05FE3, 481, 164 },
+        { 0xA59BC234DB398C25, 508, 172 },
+        { 0xF6C69A72A3989F5C, 534, 180 },
+        { 0xB7DCBF5354E9BECE, 561, 188 },
+        { 0x88FCF317F22241E2, 588, 196 },
+        { 0xCC20CE9BD35C78A5, 614, 204 },
+        { 0x98165AF37B2153DF, 641, 212 },
+        { 0xE2A0B5DC971F303A, 667, 220 },
+        { 0xA8D9D1535CE3B396, 694, 228 },
+        { 0xFB9B7CD9A4A7443C, 720, 236 },
+        { 0xBB764C4CA7A44410, 747, 244 },
+        { 0x8BAB8EEFB6409C1A, 774, 252 },
+        { 0xD01FEF10A657842C, 800, 260 },
+        { 0x9B10A4E5E9913129, 827, 268 },
+        { 0xE7109BFBA19C0C9D, 853, 276 },
+        { 0xAC2820D9623BF429, 880, 284 },
+        { 0x80444B5E7AA7CF85, 907, 292 },
+        { 0xBF21E44003ACDD2D, 933, 300 },
+        { 0x8E679C2F5E44FF8F, 960, 308 },
+        { 0xD433179D9C8CB841, 986, 316 },
+        { 0x9E19DB92B4E31BA9, 1013, 324 },
+        { 0xEB96BF6EBADF77D9, 1039, 332 },
+        { 0xAF87023B9BF0EE6B, 1066, 340 }
+    };
+
+    const CachedPower& GetCachedPower(int e)
+    {
+        // Choose the power that brings the binary exponent of its product with 2^e into the range [-60, -32],
+        // where k = ceil((-61 - e) * log10(2)) is computed in fixed point
+        int f = -61 - e;
+        int k = (f * 78913) / (1 << 18) + (f > 0);
+        int index = (300 + k + 7) / 8;
+        clcpp::internal::Assert(index >= 0 && index < int(sizeof(g_CachedPowers) / sizeof(g_CachedPowers[0])));
+        return g_CachedPowers[index];
+    }
+
+    bool GrisuRound(char* digits, int nb_digits, clcpp::uint64 dist, clcpp::uint64 delta, clcpp::uint64 rest,
+                    clcpp::uint64 ten_k, clcpp::uint64 unit)
+    {
+        // The scaled value is only known to within a unit either side, so move the last digit down while
+        // that's certain to bring it closer to the value and stay within the boundaries
+        clcpp::uint64 small_dist = dist - unit;
+        clcpp::uint64 big_dist = dist + unit;
+        while (rest < small_dist && delta - rest >= ten_k &&
+               (rest + ten_k < small_dist || small_dist - rest >= rest + ten_k - small_dist))
+        {
+            digits[nb_digits - 1]--;
+            rest += ten_k;
+        }
+
+        // Moving it down again may also be closer to the value, in which case the closest digits aren't known
+        if (rest < big_dist && delta - rest >= ten_k &&
+            (rest + ten_k < big_dist || big_dist - rest > rest + ten_k - big_dist))
+        {
+            return false;
+        }
+
+        // The digits also need to be within the boundaries allowing for the error either side of them
+        return 2 * unit <= rest && rest <= delta - 4 * unit;
+    }
+
+    bool GrisuDigits(char* digits, int& nb_digits, int& decimal_exponent, const DiyFp& minus, const DiyFp& w,
+                     const DiyFp& plus)
+    {
+        // Generate digits within the boundaries widened by the error in their scaled values, so that none
+        // are missed, leaving rounding to reject the digits that may not be within the actual boundaries
+        clcpp::uint64 unit = 1;
+        clcpp::uint64 too_high = plus.f + unit;
+        clcpp::uint64 delta = too_high - (minus.f - unit);
+        clcpp::uint64 dist = too_high - w.f;
+
+        // Split the upper boundary into its integral and fractional parts
+        const int shift = -plus.e;
+        const clcpp::uint64 one = 1ULL << shift;
+        unsigned int integral = static_cast<unsigned int>(too_high >> shift);
+        clcpp::uint64 fractional = too_high & (one - 1);
+
+        // Find the number of integral digits
+        int nb_integral = 10;
+        unsigned int pow10 = 1000000000;
+        while (nb_integral > 1 && integral < pow10)
+        {
+            pow10 /= 10;
+            nb_integral--;
+        }
+
+        // Generate integral digits until what's left is within the boundaries
+        nb_digits = 0;
+        while (nb_integral > 0)
+        {
+            digits[nb_digits++] = char('0' + integral / pow10);
+            integral %= pow10;
+            nb_integral--;
+
+            clcpp::uint64 rest = (static_cast<clcpp::uint64>(integral) << shift) + fractional;
+            if (rest < delta)
+            {
+                decimal_exponent += nb_integral;
+                return GrisuRound(digits, nb_digits, dist, delta, rest, static_cast<clcpp::uint64>(pow10) << shift, unit);
+            }
+
+            pow10 /= 10;
+        }
+
+        // Then fractional digits, scaling up the boundaries and the error with them
+        int nb_fractional = 0;
+        do
+        {
+            fractional *= 10;
+            digits[nb_digits++] = char('0' + (fractional >> shift));
+            fractional &= one - 1;
+            nb_fractional++;
+            delta *= 10;
+            unit *= 10;
+        } while (fractional >= delta);
+
+        decimal_exponent -= nb_fractional;
+        return GrisuRound(digits, nb_digits, dist * unit, delta, fractional, one, unit);
+    }
+
+    template <typename TYPE>
+    int PrintfDigits(char* digits, int& decimal_exponent, TYPE decimal)
+    {
+        // Find the fewest correctly rounded digits that load back as the same value, the way the lexer loads them
+        char text[32];
+        for (int precision = 0; precision < 17; precision++)
+        {
+            snprintf(text, sizeof(text), "%.*e", precision, static_cast<double>(decimal));
+            if (static_cast<TYPE>(strtod(text, 0)) == decimal)
+            {
+                break;
+            }
+        }
+
+        // Collect the digits either side of the decimal point, whatever the locale prints for it
+        int nb_digits = 0;
+        const char* tptr = text;
+        for (; *tptr != 'e'; tptr++)
+        {
+            if (*tptr >= '0' && *tptr <= '9')
+            {
+                digits[nb_digits++] = *tptr;
+            }
+        }
+
+        decimal_exponent = static_cast<int>(strtol(tptr + 1, 0, 10)) - (nb_digits - 1);
+        return nb_digits;
+    }
+
+    void SaveDecimalDigits(clutl::WriteBuffer& out, const char* digits, int nb_digits, int decimal_exponent)
+    {
+        // Worst case is 17 digits, a decimal point and an exponent
+        char text[32];
+        char* tptr = text;
+
+        // Position of the decimal point relative to the first digit. Values within a reasonable range are
+        // written without an exponent and always keep a decimal point so that they load as decimals.
+        int point = nb_digits + decimal_exponent;
+        if (nb_digits <= point && point <= 15)
+        {
+            // digits[000].0
+            for (int i = 0; i < nb_digits; i++)
+                *tptr++ = digits[i];
+            for (int i = nb_digits; i < point; i++)
+                *tptr++ = '0';
+            *tptr++ = '.';
+            *tptr++ = '0';
+        }
+        else if (point > 0 && point <= 15)
+        {
+            // dig.its
+            for (int i = 0; i < nb_digits; i++)
+            {
+                if (i == point)
+                    *tptr++ = '.';
+                *tptr++ = digits[i];
+            }
+        }
+        else if (point > -4 && point <= 0)
+        {
+            // 0.[000]digits
+            *tptr++ = '0';
+            *tptr++ = '.';
+            for (int i = point; i < 0; i++)
+                *tptr++ = '0';
+            for (int i = 0; i < nb_digits; i++)
+                *tptr++ = digits[i];
+        }
+        else
+        {
+            // d.igitse+xx
+            *tptr++ = digits[0];
+            if (nb_digits > 1)
+            {
+                *tptr++ = '.';
+                for (int i = 1; i < nb_digits; i++)
+                    *tptr++ = digits[i];
+            }
+
+            // Exponent has at least two digits
+            int exponent = point - 1;
+            *tptr++ = 'e';
+            *tptr++ = exponent < 0 ? '-' : '+';
+            exponent = exponent < 0 ? -exponent : exponent;
+            if (exponent >= 100)
+            {
+                *tptr++ = char('0' + exponent / 100);
+                exponent %= 100;
+            }
+            *tptr++ = g_DigitPairs[exponent * 2];
+            *tptr++ = g_DigitPairs[exponent * 2 + 1];
+        }
+
+        out.Write(text, tptr - text);
+    }
+
+    template <typename TYPE>
+    void SaveDecimal(clutl::WriteBuffer& out, TYPE decimal, unsigned int flags)
     {
         if ((flags & clutl::JSONFlags::EMIT_HEX_FLOATS) != 0)
         {
             // Use a specific prefix to inform the lexer to alias as a decimal
             out.WriteStr("0d");
-            SaveHexInteger(out, reinterpret_cast<clcpp::uint64&>(decimal));
+            SaveHexInteger(out, GetBits(static_cast<double>(decimal)));
             return;
         }
 
-        // Serialise full float rep
-        char float_buffer[512];
-        int count = snprintf(float_buffer, sizeof(float_buffer), "%f", decimal);
-        out.Write(float_buffer, count);
+        // Infinities and NaNs have no JSON representation
+        if (decimal != decimal || decimal - decimal != 0)
+        {
+            out.WriteStr("null");
+            return;
+        }
+
+        // Write the sign separately, including that of negative zero
+        if ((GetBits(decimal) >> (sizeof(decimal) * 8 - 1)) != 0)
+        {
+            out.WriteChar('-');
+            decimal = -decimal;
+        }
+        if (decimal == 0)
+        {
+            out.WriteStr("0.0");
+            return;
+        }
+
+        // Scale the value and its boundaries by a power of ten so that its digits can be generated with
+        // 64-bit integer arithmetic
+        DiyFp w, minus, plus;
+        ComputeBoundaries(decimal, w, minus, plus);
+        const CachedPower& cached = GetCachedPower(plus.e);
+        DiyFp c(cached.f, cached.e);
+        w = Multiply(w, c);
+        minus = Multiply(minus, c);
+        plus = Multiply(plus, c);
+
+        // Generate the fewest digits within the boundaries
+        char digits[32];
+        int nb_digits = 0;
+        int decimal_exponent = -cached.k;
+        if (!GrisuDigits(digits, nb_digits, decimal_exponent, minus, w, plus))
+        {
+            nb_digits = PrintfDigits(digits, decimal_exponent, decimal);
+        }
+        SaveDecimalDigits(out, digits, nb_digits, decimal_exponent);
     }
 
     void SaveDouble(clutl::WriteBuffer& out, const char* object, unsigned int flags)
@@ -712,6 +1225,7 @@ namespace
     }
     void SaveFloat(clutl::WriteBuffer& out, const char* object, unsigned int flags)
     {
+        // Save with the precision of a float so that only the digits it needs are written
         SaveDecimal(out, *reinterpret_cast<const float*>(object), flags);
     }
 
@@ -728,9 +1242,12 @@ namespace
     {
         int value = *reinterpret_cast<const int*>(object);
 
+        // Constants are written by name
+        clcpp::RequireSection(enum_type, clcpp::Database::SECTION_NAME_TEXT);
+
+        clcpp::RequireSection(enum_type, clcpp::Database::SECTION_ATTRIBUTES);
         // Is the enum a series of flags?
-        thread_local static unsigned int hash = clcpp::internal::HashNameString("flags");
-        bool are_flags = clcpp::FindPrimitive(enum_type->attributes, hash) != nullptr;
+        bool are_flags = clcpp::FindPrimitive(enum_type->attributes, "flags"_clhash) != nullptr;
         if (are_flags && value != 0)
         {
             // Linear search of all enum values testing to see if they're set as flags
@@ -772,17 +1289,13 @@ namespace
         }
         else
         {
-            // Do a linear search for an enum with a matching value
+            // Look up the enum constant with a matching value
             // Also comes through here looking for match when value=0
             const char* enum_name = "clReflect_JSON_EnumValueNotFound";
-            for (unsigned int i = 0; i < enum_type->constants.size; i++)
+            const clcpp::EnumConstant* constant = enum_type->FindConstantByValue(value);
+            if (constant != nullptr)
             {
-                int enum_value = enum_type->constants[i]->value;
-                if (enum_value == value)
-                {
-                    enum_name = enum_type->constants[i]->name.text;
-                    break;
-                }
+                enum_name = constant->name.text;
             }
 
             // Write the enum name as the value
@@ -808,14 +1321,61 @@ namespace
     }
 
     void SaveContainer(clutl::WriteBuffer& out, clcpp::ReadIterator& reader, const clcpp::Field* field, clutl::IPtrMap* ptr_map,
-                       unsigned int flags, unsigned int transient_flags)
+                       unsigned int flags, unsigned int transient_flags, bool count_hint)
     {
         // TODO: The reader knows its type and if its a pointer for all entries. Can early out on unwanted pointer saves, etc.
 
         out.WriteChar(reader.m_KeyType != nullptr ? '{' : '[');
 
+        // Lead with the value count so that the loader doesn't have to count them itself
+        if (count_hint && reader.m_KeyType == nullptr && !reader.m_ValueIsPtr)
+        {
+            out.WriteStr("{\"$n\":");
+            SaveUnsignedInteger(out, reader.m_Count);
+            out.WriteStr("},");
+        }
+
         // Save comma-separated objects
         bool written = false;
+
+        // Values stored contiguously can be walked without calling back into the iterator
+        clcpp::ContainerSpan span;
+        if (reader.m_KeyType == nullptr && reader.GetContiguous(span))
+        {
+            const char* value = static_cast<const char*>(span.data);
+            for (unsigned int i = 0; i < span.count; i++, value += span.stride)
+            {
+                if (reader.m_ValueIsPtr)
+                {
+                    // Ask the user if they want to save this pointer
+                    void* ptr = *reinterpret_cast<void* const*>(value);
+                    if (ptr_map == nullptr || !ptr_map->CanMapPtr(ptr, reader.m_ValueType))
+                    {
+                        continue;
+                    }
+                }
+
+                if (written)
+                {
+                    out.WriteChar(',');
+                }
+
+                if (reader.m_ValueIsPtr)
+                {
+                    SavePtr(out, value, ptr_map, flags);
+                }
+                else
+                {
+                    SaveObject(out, value, field, reader.m_ValueType, ptr_map, flags, transient_flags);
+                }
+
+                written = true;
+            }
+
+            out.WriteChar(']');
+            return;
+        }
+
         for (unsigned int i = 0; i < reader.m_Count; i++)
         {
             clcpp::ContainerKeyValue kv = reader.GetKeyValue();
@@ -868,7 +1428,7 @@ namespace
             return;
         }
 
-        SaveContainer(out, reader, field, ptr_map, flags, transient_flags);
+        SaveContainer(out, reader, field, ptr_map, flags, transient_flags, false);
     }
 
     inline void NewLine(clutl::WriteBuffer& out, unsigned int flags)
@@ -971,63 +1531,27 @@ namespace
     void SaveClassFields(clutl::WriteBuffer& out, const char* object, const clcpp::Class* class_type, clutl::IPtrMap* ptr_map,
                          unsigned int& flags, bool& field_written, unsigned int transient_flags)
     {
-        const clcpp::CArray<const clcpp::Field*>& fields = class_type->fields;
-        unsigned int nb_fields = fields.size;
-
-        if ((flags & clutl::JSONFlags::SORT_CLASS_FIELDS_BY_OFFSET) != 0)
-        {
-            int last_field_offset = -1;
-
-            // Save fields in offset-sorted order
-            // This is a brute-force O(n^2) implementation as I don't want to allocate any heap memory or stack memory
-            // with an upper bound. As the source array is also const and needs to be used elsewhere, sorting in-place
-            // is also not an option.
-            for (unsigned int i = 0; i < nb_fields; i++)
+        // Save the fields of the entire class hierarchy in one pass, either in declaration order or
+        // in the order of the name-sorted array
+        bool by_offset = (flags & clutl::JSONFlags::SORT_CLASS_FIELDS_BY_OFFSET) != 0;
+        const clcpp::CArray<const clcpp::Field*>& fields = by_offset ? class_type->all_fields_by_offset : class_type->all_fields;
+        const clcpp::CArray<unsigned int>& base_flags =
+            by_offset ? class_type->all_fields_by_offset_base_flags : class_type->all_fields_base_flags;
+
+        // Field names are written as keys
+        clcpp::RequireSection(class_type, clcpp::Database::SECTION_NAME_TEXT);
+
+        for (unsigned int i = 0; i < fields.size; i++)
+        {
+            // Skip transient fields, including those inherited through transient base classes
+            const clcpp::Field* field = fields[i];
+            if ((field->flag_attributes & transient_flags) != 0 ||
+                (base_flags.size != 0 && (base_flags[i] & transient_flags) != 0))
             {
-                int lowest_field_offset = 0x7FFFFFFF;
-                int lowest_field_index = -1;
-
-                // Search for the next field with the lowest offset
-                for (unsigned int j = 0; j < nb_fields; j++)
-                {
-                    // Skip transient fields
-                    const clcpp::Field* field = fields[j];
-                    if ((field->flag_attributes & transient_flags) != 0)
-                    {
-                        continue;
-                    }
-
-                    if (field->offset > last_field_offset && field->offset < lowest_field_offset)
-                    {
-                        lowest_field_offset = field->offset;
-                        lowest_field_index = j;
-                    }
-                }
-
-                // Use of transient implies not all fields may be serialised
-                if (lowest_field_index != -1)
-                {
-                    const clcpp::Field* field = fields[lowest_field_index];
-                    SaveClassField(out, object, field, ptr_map, flags, field_written, transient_flags);
-                    last_field_offset = lowest_field_offset;
-                }
+                continue;
             }
-        }
 
-        else
-        {
-            // Save fields in array order
-            for (unsigned int i = 0; i < nb_fields; i++)
-            {
-                // Skip transient fields
-                const clcpp::Field* field = fields[i];
-                if ((field->flag_attributes & transient_flags) != 0)
-                {
-                    continue;
-                }
-
-                SaveClassField(out, object, field, ptr_map, flags, field_written, transient_flags);
-            }
+            SaveClassField(out, object, field, ptr_map, flags, field_written, transient_flags);
         }
     }
 
@@ -1043,16 +1567,9 @@ namespace
                 return;
             }
 
-            // Save body of the class
+            // Save body of the class, including all base class fields
             SaveClassFields(out, object, class_type, ptr_map, flags, field_written, transient_flags);
         }
-
-        // Recurse into base types
-        for (unsigned int i = 0; i < type->base_types.size; i++)
-        {
-            const clcpp::Type* base_type = type->base_types[i];
-            SaveClass(out, object, base_type, ptr_map, flags, field_written, transient_flags);
-        }
     }
 
     void SaveClass(clutl::WriteBuffer& out, const char* object, const clcpp::Class* class_type, clutl::IPtrMap* ptr_map,
@@ -1067,9 +1584,9 @@ namespace
         // Is there a custom loading function for this class?
         if ((class_type->flag_attributes & attrFlag_CustomSave) != 0)
         {
+            clcpp::RequireSection(class_type, clcpp::Database::SECTION_ATTRIBUTES);
             // Look it up
-            thread_local static unsigned int hash = clcpp::internal::HashNameString("save_json");
-            if (const clcpp::Attribute* attr = clcpp::FindPrimitive(class_type->attributes, hash))
+            if (const clcpp::Attribute* attr = clcpp::FindPrimitive(class_type->attributes, "save_json"_clhash))
             {
                 const clcpp::PrimitiveAttribute* name_attr = attr->AsPrimitiveAttribute();
 
@@ -1100,8 +1617,8 @@ namespace
         // Call any attached pre-save function
         if ((class_type->flag_attributes & attrFlag_PreSave) != 0)
         {
-            thread_local static unsigned int hash = clcpp::internal::HashNameString("pre_save");
-            if (const clcpp::Attribute* attr = clcpp::FindPrimitive(class_type->attributes, hash))
+            clcpp::RequireSection(class_type, clcpp::Database::SECTION_ATTRIBUTES);
+            if (const clcpp::Attribute* attr = clcpp::FindPrimitive(class_type->attributes, "pre_save"_clhash))
             {
                 const clcpp::PrimitiveAttribute* name_attr = attr->AsPrimitiveAttribute();
                 if (name_attr->primitive != nullptr)
@@ -1129,7 +1646,8 @@ namespace
             return;
         }
 
-        SaveContainer(out, reader, field, ptr_map, flags, transient_flags);
+        SaveContainer(out, reader, field, ptr_map, flags, transient_flags,
+                      (flags & clutl::JSONFlags::EMIT_CONTAINER_COUNTS) != 0);
     }
 
     void SaveObject(clutl::WriteBuffer& out, const char* object, const clcpp::Field* field, const clcpp::Type* type,
@@ -1180,6 +1698,15 @@ CLCPP_API void clutl::SaveJSON(WriteBuffer& out, const void* object, const clcpp
     SaveFieldObject(out, static_cast<const char*>(object), field, ptr_map, flags, transient_flags);
 }
 
+CLCPP_API bool clutl::SaveJSON(IWriteSink& sink, const void* object, const clcpp::Type* type, IPtrMap* ptr_map,
+                               unsigned int flags, unsigned int transient_flags, unsigned int chunk_size)
+{
+    // Save through a buffer that empties into the sink as it fills
+    WriteBuffer out(&sink, chunk_size);
+    SaveJSON(out, object, type, ptr_map, flags, transient_flags);
+    return out.Flush();
+}
+
 static void SetupTypeDispatchLUT()
 {
     if (!g_TypeDispatchLUTReady)
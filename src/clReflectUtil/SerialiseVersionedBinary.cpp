@@ -165,19 +165,12 @@ namespace
 
     void SaveEnum(clutl::WriteBuffer& out, const char* object, const clcpp::Enum* enum_type)
     {
-        // Do a linear search for an enum with a matching value
-        // TODO: Optimise this to a binary search by storing sorted enum values?
-        //       They're currently sorted by name...
+        // Look up the enum constant with a matching value
         int value = *(int*)object;
         clcpp::Name enum_name;
-        for (unsigned int i = 0; i < enum_type->constants.size; i++)
-        {
-            if (enum_type->constants[i]->value == value)
-            {
-                enum_name = enum_type->constants[i]->name;
-                break;
-            }
-        }
+        const clcpp::EnumConstant* constant = enum_type->FindConstantByValue(value);
+        if (constant != nullptr)
+            enum_name = constant->name;
 
         // TODO: What if a match can't be found?
 
@@ -185,46 +178,76 @@ namespace
         out.Write(&enum_name.hash, sizeof(enum_name.hash));
     }
 
+    bool IsPlainDataValue(const clcpp::Iterator& iterator, unsigned int value_type_size)
+    {
+        // Values that serialise as a raw copy of their memory can be streamed in bulk
+        return !iterator.m_ValueIsPtr && iterator.m_ValueType != nullptr &&
+               iterator.m_ValueType->kind == clcpp::Primitive::KIND_TYPE && iterator.m_ValueType->size == value_type_size;
+    }
+
+    void SaveContainerValue(clutl::WriteBuffer& out, const ContainerChunkHeader& header, const clcpp::ReadIterator& reader,
+                            const void* value)
+    {
+        // If this is a value that could have variable data written, store a size next to it
+        SizeBackPatcher patcher;
+        if (header.valueTypeSize == 0)
+        {
+            patcher.Mark(out);
+        }
+
+        if (reader.m_ValueIsPtr)
+        {
+            // Ask the user if they want to save this pointer
+            // void* ptr = *(void**)kv.value;
+            // if (ptr_save == 0 || !ptr_save->CanMapPtr(ptr, field, reader.m_ValueType))
+            //	continue;
+
+            // SavePtr(out, kv.value, ptr_save, flags);
+        }
+        else
+        {
+            SaveObject(out, static_cast<const char*>(value), reader.m_ValueType);
+        }
+
+        // Patch any accompanying sizes
+        patcher.Patch(out);
+    }
+
     void SaveContainer(clutl::WriteBuffer& out, clcpp::ReadIterator& reader)
     {
         // Add the container header
         ContainerChunkHeader header(out, reader);
 
-        for (unsigned int i = 0; i < reader.m_Count; i++)
+        // Values stored contiguously can be walked without calling back into the iterator
+        clcpp::ContainerSpan span;
+        if (reader.m_KeyType == nullptr && reader.GetContiguous(span))
         {
-            clcpp::ContainerKeyValue kv = reader.GetKeyValue();
-
-            // Write the key value
-            if (reader.m_KeyType != nullptr)
+            if (IsPlainDataValue(reader, header.valueTypeSize) && span.stride == header.valueTypeSize)
             {
-                // TODO(don): Support for pointer keys
-                SaveObject(out, static_cast<const char*>(kv.key), reader.m_KeyType);
+                out.Write(span.data, span.count * span.stride);
+                return;
             }
 
-            // If this is a value that could have variable data written, store a size next to it
-            SizeBackPatcher patcher;
-            if (header.valueTypeSize == 0)
+            const char* value = static_cast<const char*>(span.data);
+            for (unsigned int i = 0; i < span.count; i++, value += span.stride)
             {
-                patcher.Mark(out);
+                SaveContainerValue(out, header, reader, value);
             }
+            return;
+        }
 
-            if (reader.m_ValueIsPtr)
-            {
-                // Ask the user if they want to save this pointer
-                // void* ptr = *(void**)kv.value;
-                // if (ptr_save == 0 || !ptr_save->CanMapPtr(ptr, field, reader.m_ValueType))
-                //	continue;
+        for (unsigned int i = 0; i < reader.m_Count; i++)
+        {
+            clcpp::ContainerKeyValue kv = reader.GetKeyValue();
 
-                // SavePtr(out, kv.value, ptr_save, flags);
-            }
-            else
+            // Write the key value
+            if (reader.m_KeyType != nullptr)
             {
-                SaveObject(out, (char*)kv.value, reader.m_ValueType);
+                // TODO(don): Support for pointer keys
+                SaveObject(out, static_cast<const char*>(kv.key), reader.m_KeyType);
             }
 
-            // Patch any accompanying sizes
-            patcher.Patch(out);
-
+            SaveContainerValue(out, header, reader, kv.value);
             reader.MoveNext();
         }
     }
@@ -250,8 +273,8 @@ namespace
         // TODO: Flag for marking custom saves on a field
         if (field->attributes.size != 0)
         {
-            thread_local static unsigned int hash = clcpp::internal::HashNameString("save_vbin");
-            if (const clcpp::Attribute* attr = clcpp::FindPrimitive(field->attributes, hash))
+            clcpp::RequireSection(field, clcpp::Database::SECTION_ATTRIBUTES);
+            if (const clcpp::Attribute* attr = clcpp::FindPrimitive(field->attributes, "save_vbin"_clhash))
             {
                 // Call the function to write data
                 const clcpp::PrimitiveAttribute* name_attr = attr->AsPrimitiveAttribute();
@@ -279,21 +302,21 @@ namespace
             return;
         }
 
-        // Save each field in the class
-        const clcpp::CArray<const clcpp::Field*>& fields = class_type->fields;
+        // Save each field in the class hierarchy
+        const clcpp::CArray<const clcpp::Field*>& fields = class_type->all_fields;
+        const clcpp::CArray<unsigned int>& base_flags = class_type->all_fields_base_flags;
         for (unsigned int i = 0; i < fields.size; i++)
         {
+            // Skip fields inherited through transient base classes
             const clcpp::Field* field = fields[i];
+            if (base_flags.size != 0 && (base_flags[i] & attrFlag_Transient) != 0)
+            {
+                continue;
+            }
+
             const char* field_object = object + field->offset;
             SaveClassField(out, object, field_object, field);
         }
-
-        // Recurse into base types
-        for (unsigned int i = 0; i < class_type->base_types.size; i++)
-        {
-            const clcpp::Type* base_type = class_type->base_types[i];
-            SaveClass(out, object, base_type->AsClass());
-        }
     }
 
     void SaveContainer(clutl::WriteBuffer& out, const char* object, const clcpp::Type* type)
@@ -369,6 +392,31 @@ namespace
             *(int*)object = constant->value;
     }
 
+    void LoadContainerValue(clutl::ReadBuffer& in, const ContainerChunkHeader& header, const clcpp::WriteIterator& writer,
+                            char* value_data)
+    {
+        // Check to see if this is a value type that may be variable size
+        unsigned int value_type_size = header.valueTypeSize;
+        if (value_type_size == 0)
+        {
+            in.Read(&value_type_size, sizeof(value_type_size));
+        }
+
+        if (writer.m_ValueIsPtr)
+        {
+            // Ask the user if they want to save this pointer
+            // void* ptr = *(void**)kv.value;
+            // if (ptr_save == 0 || !ptr_save->CanMapPtr(ptr, field, reader.m_ValueType))
+            //	continue;
+
+            // SavePtr(out, kv.value, ptr_save, flags);
+        }
+        else
+        {
+            LoadObject(in, value_data, writer.m_ValueType, value_type_size, writer.m_ValueType->name.hash);
+        }
+    }
+
     void LoadContainer(clutl::ReadBuffer& in, clcpp::WriteIterator& writer, unsigned int data_size, unsigned int expected_count)
     {
         unsigned int end_pos = in.GetBytesRead() + data_size;
@@ -398,44 +446,53 @@ namespace
             return;
         }
 
-        for (unsigned int i = 0; i < count; i++)
+        // Where the container can hand out contiguous blocks of values, fill them in place without
+        // calling back into the iterator for each value
+        unsigned int nb_loaded = 0;
+        clcpp::ContainerSpan span;
+        while (writer.m_KeyType == nullptr && nb_loaded < count && writer.AddEmptyRange(count - nb_loaded, span))
         {
-            char* value_data;
-            if (writer.m_KeyType != nullptr)
+            // Stop loading if the container has run out of storage
+            if (span.count == 0)
             {
-                // Load the key value onto the stack
-                char key_data[128];
-                clcpp::internal::Assert(writer.m_KeyType->size < sizeof(key_data));
-                LoadObject(in, key_data, writer.m_KeyType, header.keyTypeSize, header.keyTypeHash);
+                count = nb_loaded;
+                break;
+            }
 
-                // Allocate space for the new data with its key
-                value_data = static_cast<char*>(writer.AddEmpty(key_data));
+            if (IsPlainDataValue(writer, header.valueTypeSize) && span.stride == header.valueTypeSize)
+            {
+                in.Read(span.data, span.count * span.stride);
             }
             else
             {
-                value_data = static_cast<char*>(writer.AddEmpty());
+                char* value_data = static_cast<char*>(span.data);
+                for (unsigned int i = 0; i < span.count; i++, value_data += span.stride)
+                {
+                    LoadContainerValue(in, header, writer, value_data);
+                }
             }
 
-            // Check to see if this is a value type that may be variable size
-            unsigned int value_type_size = header.valueTypeSize;
-            if (value_type_size == 0)
-            {
-                in.Read(&value_type_size, sizeof(value_type_size));
-            }
+            nb_loaded += span.count;
+        }
 
-            if (writer.m_ValueIsPtr)
+        for (; nb_loaded < count; nb_loaded++)
+        {
+            char* value_data;
+            if (writer.m_KeyType != nullptr)
             {
-                // Ask the user if they want to save this pointer
-                // void* ptr = *(void**)kv.value;
-                // if (ptr_save == 0 || !ptr_save->CanMapPtr(ptr, field, reader.m_ValueType))
-                //	continue;
+                // Load the key value onto the stack
+                clutl::ContainerKey key(writer.m_KeyType);
+                LoadObject(in, static_cast<char*>(key.GetData()), writer.m_KeyType, header.keyTypeSize, header.keyTypeHash);
 
-                // SavePtr(out, kv.value, ptr_save, flags);
+                // Allocate space for the new data with its key
+                value_data = static_cast<char*>(writer.AddEmpty(key.GetData()));
             }
             else
             {
-                LoadObject(in, value_data, writer.m_ValueType, value_type_size, writer.m_ValueType->name.hash);
+                value_data = static_cast<char*>(writer.AddEmpty());
             }
+
+            LoadContainerValue(in, header, writer, value_data);
         }
 
         int bytes_left = end_pos - in.GetBytesRead();
@@ -468,31 +525,11 @@ namespace
         LoadContainer(in, writer, data_size, field->ci->count);
     }
 
-    const clcpp::Field* FindFieldsRecursive(const clcpp::Class* type, unsigned int hash)
-    {
-        // Check fields of this class
-        if (const clcpp::Field* field = clcpp::FindPrimitive(type->fields, hash))
-        {
-            return field;
-        }
-
-        // Search up through the inheritance hierarchy
-        for (unsigned int i = 0; i < type->base_types.size; i++)
-        {
-            if (const clcpp::Field* field = FindFieldsRecursive(type->base_types[i]->AsClass(), hash))
-            {
-                return field;
-            }
-        }
-
-        return nullptr;
-    }
-
     void LoadClassField(clutl::ReadBuffer& in, char* object, const clcpp::Class* class_type)
     {
         // Read the header and skip the chunk if the field doesn't exist or its destination is transient
         ChunkHeader header(in);
-        const clcpp::Field* field = FindFieldsRecursive(class_type, header.name_hash);
+        const clcpp::Field* field = clcpp::FindPrimitive(class_type->all_fields, header.name_hash);
         if (field == nullptr || (field->flag_attributes & attrFlag_Transient) != 0)
         {
             in.SeekRel(header.data_size);
@@ -504,8 +541,8 @@ namespace
         // TODO: Flag for marking custom loads on a field
         if (field->attributes.size != 0)
         {
-            thread_local static unsigned int hash = clcpp::internal::HashNameString("load_vbin");
-            if (const clcpp::Attribute* attr = clcpp::FindPrimitive(field->attributes, hash))
+            clcpp::RequireSection(field, clcpp::Database::SECTION_ATTRIBUTES);
+            if (const clcpp::Attribute* attr = clcpp::FindPrimitive(field->attributes, "load_vbin"_clhash))
             {
                 int end_pos = in.GetBytesRead() + header.data_size;
 